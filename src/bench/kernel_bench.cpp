@@ -0,0 +1,180 @@
+/*-------------------------------EXE INFO------------------------------/
+ * \file kernel_bench.cpp
+ * \author Delyan Kirov
+ * \executable kernel_bench.exe
+ * \extends parser, tokenizer, vm, jit
+ * \brief Rows per second of every bit-sliced evaluation kernel and the JIT
+ *---------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------/
+ *-----------------------------EXE INCLUDES------------------------------/
+ *----------------------------------------------------------------------*/
+#include "jit.hpp"
+#include "parser.hpp"
+#include "tokenizer.hpp"
+#include "vm.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*----------------------------------------------------------------------/
+ *------------------------------EXE IMPL--------------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief The ic2 test definition repeated over groups of four inputs
+static std::string
+generateDefinition (size_t groups)
+{
+  std::string arguments;
+  std::string body;
+  for (size_t i = 0; i < groups; ++i)
+    {
+      std::string a = "a" + std::to_string (i), b = "b" + std::to_string (i),
+                  c = "c" + std::to_string (i), d = "d" + std::to_string (i);
+      arguments += (i > 0 ? ", " : "") + a + ", " + b + ", " + c + ", " + d;
+      body += (i > 0 ? " | " : "") + ("(" + a + " & (" + b + " | " + c
+                                      + ") & !" + d + ")");
+    }
+  return "DEFINE ic2(" + arguments + "): \"" + body + "\"\n";
+}
+
+//! \brief Evaluate the first rows of a program with a kernel
+//! \return the number of ones
+static uint64_t
+countOnes (const Vm::Kernel &kernel, const Vm::Program &program,
+           uint64_t rows)
+{
+  uint32_t inputs = program.inputs;
+  uint64_t blockRows = uint64_t (kernel.words) * Vm::sliceLanes;
+  std::vector<uint64_t> words (inputs * kernel.words);
+  std::vector<uint64_t> results (kernel.words);
+  uint64_t ones = 0;
+
+  for (uint64_t first = 0; first < rows; first += blockRows)
+    {
+      Vm::sliceBlock (inputs, kernel.words, first,
+                      first == 0 ? ~first : first - blockRows, words.data ());
+      kernel.run (program, words.data (), results.data ());
+      for (uint64_t result : results)
+        ones += std::popcount (result);
+    }
+  return ones;
+}
+
+//! \brief Evaluate the first rows of a program with its machine code
+//! \return the number of ones
+static uint64_t
+countOnes (const Jit::Function &function, uint32_t inputs, uint64_t rows)
+{
+  std::vector<uint64_t> words (inputs);
+  uint64_t ones = 0;
+
+  for (uint64_t first = 0; first < rows; first += Vm::sliceLanes)
+    {
+      Vm::sliceBlock (inputs, 1, first,
+                      first == 0 ? ~first : first - Vm::sliceLanes,
+                      words.data ());
+      ones += std::popcount (Jit::run (function, words.data ()));
+    }
+  return ones;
+}
+
+//! \brief Seconds taken by count, its result stored in ones
+template <typename Count>
+static double
+timeCount (Count count, uint64_t &ones)
+{
+  auto start = std::chrono::steady_clock::now ();
+  ones = count ();
+  std::chrono::duration<double> elapsed
+      = std::chrono::steady_clock::now () - start;
+  return elapsed.count ();
+}
+
+/*----------------------------------------------------------------------/
+ *---------------------------------MAIN---------------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Main function for kernel_bench.exe
+int
+main (int argc, char *argv[])
+{
+  size_t inputs = argc > 1 ? atoi (argv[1]) : 32;
+  size_t groups = std::clamp<size_t> ((inputs + 3) / 4, 2, 15);
+  std::string script = generateDefinition (groups);
+
+  Tokenizer::TokenStream tokens
+      = Tokenizer::tokenize (script.data (), script.size ());
+  Parser::Command command = Parser::parse (0, &tokens).second;
+  if (command.definition == nullptr)
+    {
+      std::cerr << "BENCH ERROR: could not parse the definition\n";
+      return 1;
+    }
+  Parser::bindArguments (*command.definition, command.arguments);
+  Vm::Program *program = Vm::compile (command.definition->nodes,
+                                      command.arguments.size ());
+
+  // The first 2^28 rows of the table are enough for a stable rate
+  uint64_t rows = uint64_t (1) << std::min (program->inputs, 28u);
+  std::cout << "BENCH KERNELS: " << program->inputs << " inputs, "
+            << program->code.size () << " instructions, " << rows
+            << " rows\n";
+
+  uint64_t expected = 0;
+  double scalarRate = 0;
+  auto report = [&] (const char *name, double time, uint64_t ones) {
+    double rate = rows / time;
+    if (scalarRate == 0)
+      {
+        scalarRate = rate;
+        expected = ones;
+      }
+    std::cout << name << '\t' << rate / 1e6 << " Mrows/s\tspeedup "
+              << rate / scalarRate << '\n';
+    if (ones == expected) return true;
+    std::cerr << "BENCH ERROR: " << name << " counted " << ones
+              << " ones instead of " << expected << '\n';
+    return false;
+  };
+
+  for (const Vm::Kernel &kernel : Vm::kernels ())
+    {
+      if (!kernel.supported ())
+        {
+          std::cout << kernel.name << "\tnot supported\n";
+          continue;
+        }
+      uint64_t ones;
+      double time = timeCount (
+          [&] () { return countOnes (kernel, *program, rows); }, ones);
+      if (!report (kernel.name, time, ones)) return 1;
+    }
+
+  Jit::Function *function = Jit::compile (*program);
+  if (function == nullptr)
+    {
+      std::cout << "jit\tnot supported\n";
+    }
+  else
+    {
+      uint64_t ones;
+      double time = timeCount (
+          [&] () { return countOnes (*function, program->inputs, rows); },
+          ones);
+      delete function;
+      if (!report ("jit", time, ones)) return 1;
+    }
+
+  delete program;
+  delete command.definition;
+  return 0;
+}
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
@@ -0,0 +1,119 @@
+/*-------------------------------EXE INFO------------------------------/
+ * \file tokenizer_bench.cpp
+ * \author Delyan Kirov
+ * \executable tokenizer_bench.exe
+ * \extends tokenizer
+ * \brief Scaling of the parallel tokenizer against the serial one
+ *---------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------/
+ *-----------------------------EXE INCLUDES------------------------------/
+ *----------------------------------------------------------------------*/
+#include "tokenizer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+/*----------------------------------------------------------------------/
+ *------------------------------EXE IMPL--------------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Generate a script of DEFINE, RUN and FIND units of about size
+//!        bytes
+//! \details Every eighth definition is followed by a FIND table over
+//!          several lines and a FIND of a file, so chunk boundaries also
+//!          fall inside multi-line units.
+static std::string
+generateScript (size_t size)
+{
+  std::string script;
+  script.reserve (size + 256);
+  for (size_t i = 0; script.size () < size; ++i)
+    {
+      std::string name = "f" + std::to_string (i % 4096);
+      script += "DEFINE " + name + "(a, b, c, d): \"a & (b | c) & !d\"\n";
+      for (int j = 0; j < 8; ++j)
+        script += "RUN " + name + "(1, 0, 1, " + std::to_string (j & 1)
+                  + ")\n";
+      if (i % 8 == 0)
+        script += "FIND 0,0:0;\n     0,1:1;\n     1,0:1;\n     1,1:"
+                  + std::to_string (i & 1) + "\nFIND \"table.csv\"\n";
+    }
+  return script;
+}
+
+//! \brief Check that two token streams hold the same tokens
+static bool
+sameTokens (const Tokenizer::TokenStream &a, const Tokenizer::TokenStream &b)
+{
+  return a.types == b.types && a.offsets == b.offsets
+         && a.lengths == b.lengths && a.symbols == b.symbols;
+}
+
+//! \brief Seconds taken by the fastest of a few runs of tokenize
+template <typename Tokenize>
+static double
+timeTokenize (Tokenize tokenize, Tokenizer::TokenStream &result)
+{
+  double best = 1e300;
+  for (int run = 0; run < 3; ++run)
+    {
+      auto start = std::chrono::steady_clock::now ();
+      result = tokenize ();
+      std::chrono::duration<double> elapsed
+          = std::chrono::steady_clock::now () - start;
+      if (elapsed.count () < best) best = elapsed.count ();
+    }
+  return best;
+}
+
+/*----------------------------------------------------------------------/
+ *---------------------------------MAIN---------------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Main function for tokenizer_bench.exe
+int
+main (int argc, char *argv[])
+{
+  size_t megabytes = argc > 1 ? atoi (argv[1]) : 64;
+  unsigned cores = std::thread::hardware_concurrency ();
+  std::string script = generateScript (megabytes << 20);
+  double size = script.size () / double (1 << 20);
+
+  Tokenizer::TokenStream serial;
+  double serialTime = timeTokenize (
+      [&] () { return Tokenizer::tokenize (script.data (), script.size ()); },
+      serial);
+
+  std::cout << "BENCH TOKENIZER: " << size << " MiB, " << serial.size ()
+            << " tokens, " << cores << " cores\n";
+  std::cout << "serial\t" << size / serialTime << " MiB/s\n";
+
+  for (unsigned threads = 1; threads <= std::max (2 * cores, 8u);
+       threads *= 2)
+    {
+      Tokenizer::TokenStream parallel;
+      double time = timeTokenize (
+          [&] () {
+            return Tokenizer::tokenizeParallel (script.data (),
+                                                script.size (), threads);
+          },
+          parallel);
+      if (!sameTokens (serial, parallel))
+        {
+          std::cerr << "BENCH ERROR: token streams differ with " << threads
+                    << " threads\n";
+          return 1;
+        }
+      std::cout << "threads=" << threads << '\t' << size / time
+                << " MiB/s\tspeedup " << serialTime / time << '\n';
+    }
+  return 0;
+}
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
@@ -0,0 +1,237 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file aig.cpp
+ * \author Delyan Kirov
+ * \brief Implementation of the And-Inverter Graph representation
+ *---------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+
+#include "aig.hpp"
+#include "parser.hpp"
+#include <utility>
+#include <vector>
+
+namespace Aig
+{
+namespace
+{
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE DEFINES-----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Upper bound on rewriting passes, each one must shrink the graph
+constexpr int maxRewritePasses = 4;
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE IMPL-----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief AND of two literals using two level rewriting rules
+//! \details Looks one level into AND fanins for contradiction,
+//!          idempotence, subsumption and substitution before falling back
+//!          to the structurally hashed AND.
+static Literal
+rewriteAnd (Graph &graph, Literal a, Literal b)
+{
+  for (int side = 0; side < 2; ++side, std::swap (a, b))
+    {
+      if (!graph.isAnd (a)) continue;
+      Literal a0 = graph.nodes[nodeOf (a)].left;
+      Literal a1 = graph.nodes[nodeOf (a)].right;
+
+      if (!isComplemented (a))
+        {
+          // (a0 & a1) & !a0 = 0
+          if (b == negate (a0) || b == negate (a1)) return FALSE;
+          // (a0 & a1) & a0 = a0 & a1
+          if (b == a0 || b == a1) return a;
+          if (graph.isAnd (b) && !isComplemented (b))
+            {
+              Literal b0 = graph.nodes[nodeOf (b)].left;
+              Literal b1 = graph.nodes[nodeOf (b)].right;
+              // (a0 & a1) & (!a0 & b1) = 0
+              if (a0 == negate (b0) || a0 == negate (b1)
+                  || a1 == negate (b0) || a1 == negate (b1))
+                return FALSE;
+            }
+        }
+      else
+        {
+          // !(a0 & a1) & !a0 = !a0
+          if (b == negate (a0) || b == negate (a1)) return b;
+          // !(a0 & a1) & a0 = a0 & !a1
+          if (b == a0) return rewriteAnd (graph, b, negate (a1));
+          if (b == a1) return rewriteAnd (graph, b, negate (a0));
+          if (graph.isAnd (b) && !isComplemented (b))
+            {
+              Literal b0 = graph.nodes[nodeOf (b)].left;
+              Literal b1 = graph.nodes[nodeOf (b)].right;
+              // !(a0 & a1) & (!a0 & b1) = !a0 & b1
+              if (negate (a0) == b0 || negate (a0) == b1
+                  || negate (a1) == b0 || negate (a1) == b1)
+                return b;
+            }
+        }
+    }
+  return graph.createAnd (a, b);
+}
+
+//! \brief Rebuild the output cone once through rewriteAnd
+static Graph *
+rewritePass (const Graph &graph)
+{
+  std::vector<bool> reachable (graph.nodes.size (), false);
+  reachable[nodeOf (graph.output)] = true;
+  for (size_t i = graph.nodes.size (); i-- > graph.inputs + 1;)
+    {
+      if (!reachable[i]) continue;
+      reachable[nodeOf (graph.nodes[i].left)] = true;
+      reachable[nodeOf (graph.nodes[i].right)] = true;
+    }
+
+  Graph *result = new Graph (graph.inputs);
+  std::vector<Literal> map (graph.nodes.size ());
+  for (uint32_t i = 0; i <= graph.inputs; ++i)
+    map[i] = i << 1;
+
+  auto mapped = [&map] (Literal literal) {
+    return map[nodeOf (literal)] ^ (literal & 1);
+  };
+  for (size_t i = graph.inputs + 1; i < graph.nodes.size (); ++i)
+    {
+      if (!reachable[i]) continue;
+      map[i] = rewriteAnd (*result, mapped (graph.nodes[i].left),
+                           mapped (graph.nodes[i].right));
+    }
+  result->output = mapped (graph.output);
+  return result;
+}
+} // end namespace
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE EXPR-----------------------------/
+ *---------------------------------------------------------------------*/
+
+Graph::Graph (uint32_t inputCount) : inputs (inputCount)
+{
+  nodes.resize (inputCount + 1, { FALSE, FALSE });
+}
+
+//! \brief Return the AND of two literals, reusing an identical node
+Literal
+Graph::createAnd (Literal left, Literal right)
+{
+  if (left > right) std::swap (left, right);
+  if (left == FALSE) return FALSE;
+  if (left == TRUE) return right;
+  if (left == right) return left;
+  if (left == negate (right)) return FALSE;
+
+  uint64_t key = (uint64_t)left << 32 | right;
+  auto found = strash.find (key);
+  if (found != strash.end ()) return found->second;
+
+  Literal literal = nodes.size () << 1;
+  nodes.push_back ({ left, right });
+  strash.emplace (key, literal);
+  return literal;
+}
+
+//! \brief Lower bound syntax tree nodes, nullptr if a variable is unbound
+extern Graph *
+lower (Parser::NodeSpan tree, uint32_t inputs)
+{
+  using Parser::AlgebraType;
+  using Parser::OperationType;
+
+  Graph *graph = new Graph (inputs);
+  // The pool is in post order, so the fanins of a node are already lowered
+  std::vector<Literal> literals (tree.size ());
+  for (size_t i = 0; i < tree.size (); ++i)
+    {
+      const Parser::SynNode &node = tree[i];
+      switch (node.val.type)
+        {
+        case AlgebraType::VALUE:
+          literals[i] = node.val.value ? TRUE : FALSE;
+          break;
+        case AlgebraType::VARIABLE:
+          if (node.slot == Parser::NO_SLOT)
+            {
+              delete graph;
+              return nullptr;
+            }
+          literals[i] = graph->input (node.slot);
+          break;
+        case AlgebraType::OPERATION:
+          {
+            // NOT only has a right operand
+            Literal right = literals[node.right];
+            switch (node.val.operation)
+              {
+              case OperationType::AND:
+                literals[i] = graph->createAnd (literals[node.left], right);
+                break;
+              case OperationType::OR:
+                literals[i] = negate (graph->createAnd (
+                    negate (literals[node.left]), negate (right)));
+                break;
+              case OperationType::NOT: literals[i] = negate (right); break;
+              }
+          }
+          break;
+        default:
+          delete graph;
+          return nullptr;
+        }
+    }
+  graph->output = literals.empty () ? FALSE : literals.back ();
+  return graph;
+}
+
+//! \brief Rebuild the cone of the output applying local rewriting rules
+extern Graph *
+rewrite (const Graph &graph)
+{
+  Graph *result = rewritePass (graph);
+  for (int pass = 1; pass < maxRewritePasses; ++pass)
+    {
+      Graph *next = rewritePass (*result);
+      if (next->andCount () >= result->andCount ())
+        {
+          delete next;
+          break;
+        }
+      delete result;
+      result = next;
+    }
+  result->strash = {}; // Only needed while building
+  return result;
+}
+
+//! \brief Evaluate the graph for one assignment of its inputs
+extern unsigned char
+evaluate (const Graph &graph, const std::vector<unsigned char> &values)
+{
+  static thread_local std::vector<unsigned char> nodeValues;
+  nodeValues.resize (graph.nodes.size ());
+
+  nodeValues[0] = 0;
+  for (uint32_t i = 0; i < graph.inputs; ++i)
+    nodeValues[i + 1] = values[i];
+
+  auto value = [] (Literal literal) {
+    return nodeValues[nodeOf (literal)] ^ (literal & 1);
+  };
+  for (size_t i = graph.inputs + 1; i < graph.nodes.size (); ++i)
+    nodeValues[i]
+        = value (graph.nodes[i].left) & value (graph.nodes[i].right);
+  return value (graph.output);
+}
+} // end namespace Aig
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
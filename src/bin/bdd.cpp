@@ -0,0 +1,398 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file bdd.cpp
+ * \author Delyan Kirov
+ * \brief Implementation of the reduced ordered Binary Decision Diagrams
+ * \details One manager holds every diagram: a unique table of nodes
+ *          chained through their next field, a direct mapped computed
+ *          table for AND and a mark and sweep collector over the roots
+ *          still referenced. High edges are never complemented, so every
+ *          function has exactly one edge.
+ *---------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+
+#include "bdd.hpp"
+#include "parser.hpp"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Bdd
+{
+namespace
+{
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE DEFINES-----------------------------/
+ *---------------------------------------------------------------------*/
+
+constexpr uint32_t TERMINAL_VAR = UINT32_MAX; // Below every variable
+constexpr uint32_t FREE_VAR = UINT32_MAX - 1; // Node on the free list
+constexpr uint32_t NO_NEXT = UINT32_MAX;
+
+//! \brief Nodes a single build may grow the manager to, 64 MiB
+constexpr size_t maxNodes = 1 << 22;
+
+//! \brief Entries of the computed table, a power of two
+constexpr size_t cacheSize = 1 << 16;
+
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE TYPES-------------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Decision on var, low taken when it is 0 and high when it is 1
+struct Node
+{
+  uint32_t var;
+  Edge low;
+  Edge high;
+  uint32_t next; // Next node of the unique table bucket or free list
+};
+
+//! \brief Computed table entry, the AND of f and g
+struct CacheEntry
+{
+  Edge f = NONE;
+  Edge g = NONE;
+  Edge result = NONE;
+};
+
+//! \brief Shared state of all diagrams
+struct Manager
+{
+  std::vector<Node> nodes{ { TERMINAL_VAR, ONE, ONE, NO_NEXT } };
+  std::vector<uint32_t> buckets = std::vector<uint32_t> (1 << 10, NO_NEXT);
+  uint32_t freeList = NO_NEXT;
+  std::vector<CacheEntry> cache = std::vector<CacheEntry> (cacheSize);
+  std::unordered_map<Edge, uint32_t> roots{}; // Reference count per root
+  Stats stats{ 0, 0, 1, 0 };
+  size_t collectAt = 1 << 16; // Live nodes that trigger a collection
+  bool overflow = false;      // A build went over maxNodes
+};
+
+Manager manager;
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE IMPL-----------------------------/
+ *---------------------------------------------------------------------*/
+
+static inline uint32_t
+nodeOf (Edge edge)
+{
+  return edge >> 1;
+}
+
+static inline Edge
+negate (Edge edge)
+{
+  return edge ^ 1;
+}
+
+static inline uint32_t
+varOf (Edge edge)
+{
+  return manager.nodes[nodeOf (edge)].var;
+}
+
+static inline size_t
+hash (uint64_t a, uint64_t b, uint64_t c)
+{
+  return (a * 0x9E3779B97F4A7C15ull) ^ (b * 0xC2B2AE3D27D4EB4Full)
+         ^ (c * 0x165667B19E3779F9ull) ^ (c >> 17);
+}
+
+//! \brief Rebuild the unique table chains with size buckets
+static void
+rehash (size_t size)
+{
+  manager.buckets.assign (size, NO_NEXT);
+  for (uint32_t i = 1; i < manager.nodes.size (); ++i)
+    {
+      Node &node = manager.nodes[i];
+      if (node.var == FREE_VAR) continue;
+      size_t bucket = hash (node.var, node.low, node.high) & (size - 1);
+      node.next = manager.buckets[bucket];
+      manager.buckets[bucket] = i;
+    }
+}
+
+//! \brief The unique node for var, low and high
+//! \details A redundant test is skipped and a complemented high edge is
+//!          moved onto the returned edge, which keeps the form canonical.
+static Edge
+makeNode (uint32_t var, Edge low, Edge high)
+{
+  if (low == high) return low;
+  Edge complement = high & 1;
+  low ^= complement;
+  high ^= complement;
+
+  size_t bucket = hash (var, low, high) & (manager.buckets.size () - 1);
+  for (uint32_t i = manager.buckets[bucket]; i != NO_NEXT;
+       i = manager.nodes[i].next)
+    {
+      const Node &node = manager.nodes[i];
+      if (node.var == var && node.low == low && node.high == high)
+        return i << 1 | complement;
+    }
+
+  if (manager.stats.liveNodes >= maxNodes)
+    {
+      manager.overflow = true;
+      return ZERO;
+    }
+
+  uint32_t index;
+  Node node{ var, low, high, manager.buckets[bucket] };
+  if (manager.freeList != NO_NEXT)
+    {
+      index = manager.freeList;
+      manager.freeList = manager.nodes[index].next;
+      manager.nodes[index] = node;
+    }
+  else
+    {
+      index = manager.nodes.size ();
+      manager.nodes.push_back (node);
+    }
+  manager.buckets[bucket] = index;
+  if (++manager.stats.liveNodes > 2 * manager.buckets.size ())
+    rehash (2 * manager.buckets.size ());
+  return index << 1 | complement;
+}
+
+//! \brief Children of f when var is decided, f itself if f skips var
+static void
+cofactors (Edge f, uint32_t var, Edge &low, Edge &high)
+{
+  const Node &node = manager.nodes[nodeOf (f)];
+  if (node.var != var)
+    {
+      low = high = f;
+      return;
+    }
+  low = node.low ^ (f & 1);
+  high = node.high ^ (f & 1);
+}
+
+//! \brief AND of two diagrams, recursion depth bounded by the inputs
+static Edge
+conjoin (Edge f, Edge g)
+{
+  if (f == ZERO || g == ZERO || f == negate (g)) return ZERO;
+  if (f == ONE || f == g) return g;
+  if (g == ONE) return f;
+  if (manager.overflow) return ZERO;
+  if (f > g) std::swap (f, g);
+
+  size_t slot = hash (f, g, 0) & (cacheSize - 1);
+  ++manager.stats.cacheLookups;
+  if (manager.cache[slot].f == f && manager.cache[slot].g == g)
+    {
+      ++manager.stats.cacheHits;
+      return manager.cache[slot].result;
+    }
+
+  uint32_t var = std::min (varOf (f), varOf (g));
+  Edge f0, f1, g0, g1;
+  cofactors (f, var, f0, f1);
+  cofactors (g, var, g0, g1);
+  Edge low = conjoin (f0, g0);
+  Edge high = conjoin (f1, g1);
+  Edge result = makeNode (var, low, high);
+
+  if (!manager.overflow) manager.cache[slot] = { f, g, result };
+  return result;
+}
+
+//! \brief Fraction of the assignments below a node that reach ONE
+static double
+density (Edge edge, std::unordered_map<uint32_t, double> &memo)
+{
+  double fraction;
+  uint32_t index = nodeOf (edge);
+  if (index == 0)
+    {
+      fraction = 1;
+    }
+  else
+    {
+      auto found = memo.find (index);
+      if (found != memo.end ())
+        {
+          fraction = found->second;
+        }
+      else
+        {
+          const Node node = manager.nodes[index];
+          fraction = (density (node.low, memo) + density (node.high, memo))
+                     / 2;
+          memo.emplace (index, fraction);
+        }
+    }
+  return edge & 1 ? 1 - fraction : fraction;
+}
+} // end namespace
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE EXPR-----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Build the diagram of bound syntax tree nodes
+extern Edge
+build (Parser::NodeSpan nodes)
+{
+  using Parser::AlgebraType;
+  using Parser::OperationType;
+
+  if (manager.stats.liveNodes > manager.collectAt)
+    {
+      collect ();
+      manager.collectAt = std::max<size_t> (1 << 16,
+                                            2 * manager.stats.liveNodes);
+    }
+
+  // No garbage is collected while building, partial results are safe
+  std::vector<Edge> edges (nodes.size ());
+  for (size_t i = 0; i < nodes.size (); ++i)
+    {
+      const Parser::SynNode &node = nodes[i];
+      switch (node.val.type)
+        {
+        case AlgebraType::VALUE:
+          edges[i] = node.val.value ? ONE : ZERO;
+          break;
+        case AlgebraType::VARIABLE:
+          if (node.slot == Parser::NO_SLOT) return NONE;
+          edges[i] = makeNode (node.slot, ZERO, ONE);
+          break;
+        case AlgebraType::OPERATION:
+          switch (node.val.operation)
+            {
+            case OperationType::AND:
+              edges[i] = conjoin (edges[node.left], edges[node.right]);
+              break;
+            case OperationType::OR:
+              edges[i] = negate (conjoin (negate (edges[node.left]),
+                                          negate (edges[node.right])));
+              break;
+            case OperationType::NOT:
+              edges[i] = negate (edges[node.right]);
+              break;
+            }
+          break;
+        default: return NONE;
+        }
+    }
+
+  if (manager.overflow)
+    {
+      manager.overflow = false;
+      collect ();
+      return NONE;
+    }
+  Edge root = nodes.empty () ? ZERO : edges.back ();
+  ++manager.roots[root];
+  return root;
+}
+
+//! \brief Drop the reference on a root returned by build
+extern void
+release (Edge root)
+{
+  auto found = manager.roots.find (root);
+  if (found == manager.roots.end ()) return;
+  if (--found->second == 0) manager.roots.erase (found);
+}
+
+//! \brief Follow one path from the root, at most one node per input
+extern unsigned char
+evaluate (Edge root, const std::vector<unsigned char> &values)
+{
+  Edge edge = root;
+  while (nodeOf (edge) != 0)
+    {
+      const Node &node = manager.nodes[nodeOf (edge)];
+      edge = (values[node.var] ? node.high : node.low) ^ (edge & 1);
+    }
+  return edge == ONE;
+}
+
+//! \brief Number of nodes reachable from a root, the terminal included
+extern size_t
+nodeCount (Edge root)
+{
+  std::vector<bool> seen (manager.nodes.size (), false);
+  std::vector<uint32_t> stack{ nodeOf (root) };
+  size_t count = 0;
+  while (!stack.empty ())
+    {
+      uint32_t index = stack.back ();
+      stack.pop_back ();
+      if (seen[index]) continue;
+      seen[index] = true;
+      ++count;
+      if (index == 0) continue;
+      stack.push_back (nodeOf (manager.nodes[index].low));
+      stack.push_back (nodeOf (manager.nodes[index].high));
+    }
+  return count;
+}
+
+//! \brief Number of satisfying assignments of the inputs, linear in size
+extern double
+satCount (Edge root, uint32_t inputs)
+{
+  std::unordered_map<uint32_t, double> memo;
+  return std::ldexp (density (root, memo), inputs);
+}
+
+//! \brief Free every node no referenced root reaches
+extern void
+collect ()
+{
+  std::vector<bool> marked (manager.nodes.size (), false);
+  std::vector<uint32_t> stack;
+  for (const auto &root : manager.roots)
+    stack.push_back (nodeOf (root.first));
+  while (!stack.empty ())
+    {
+      uint32_t index = stack.back ();
+      stack.pop_back ();
+      if (marked[index]) continue;
+      marked[index] = true;
+      if (index == 0) continue;
+      stack.push_back (nodeOf (manager.nodes[index].low));
+      stack.push_back (nodeOf (manager.nodes[index].high));
+    }
+
+  for (uint32_t i = 1; i < manager.nodes.size (); ++i)
+    {
+      Node &node = manager.nodes[i];
+      if (marked[i] || node.var == FREE_VAR) continue;
+      node.var = FREE_VAR;
+      node.next = manager.freeList;
+      manager.freeList = i;
+      --manager.stats.liveNodes;
+    }
+
+  // Freed nodes may be reused, so no chain or cached result may name them
+  rehash (manager.buckets.size ());
+  std::fill (manager.cache.begin (), manager.cache.end (), CacheEntry{});
+  ++manager.stats.collections;
+}
+
+//! \brief Statistics of the shared manager
+extern const Stats &
+stats ()
+{
+  return manager.stats;
+}
+} // end namespace Bdd
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
@@ -0,0 +1,352 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file image.cpp
+ * \author Delyan Kirov
+ * \brief Implementation of binary namespace images
+ *---------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+
+#include "image.hpp"
+#include "interpreter.hpp"
+#include "parser.hpp"
+#include "symbols.hpp"
+#include "tokenizer.hpp"
+#include "vm.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <vector>
+
+namespace Image
+{
+namespace
+{
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE DEFINES-----------------------------/
+ *---------------------------------------------------------------------*/
+
+constexpr char imageMagic[8] = { 'D', 'I', 'S', 'I', 'M', 'A', 'G', 'E' };
+constexpr uint32_t imageVersion = 2;
+
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE TYPES-------------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Image layout: Header, FunctionRecord[functionCount], the
+//!        StringRef table of argument names, the 16 byte aligned node
+//!        pools and bytecode of every function and finally the string
+//!        blob.
+struct Header
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t nodeSize; // sizeof (SynNode) of the writer
+  uint32_t functionCount;
+  uint32_t argumentCount;
+  uint64_t stringsOffset;
+  uint64_t stringsSize;
+};
+
+struct StringRef
+{
+  uint32_t offset; // Into the string blob
+  uint32_t length;
+};
+
+struct FunctionRecord
+{
+  StringRef name;
+  uint32_t argCount;
+  uint32_t argsIndex; // First argument in the StringRef table
+  uint64_t nodesOffset;
+  uint64_t nodeCount;
+  uint64_t codeOffset;
+  uint64_t codeCount;
+  uint32_t maxStack;
+  uint32_t temps;
+};
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE DATA-----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Loaded images stay mapped for the lifetime of the process
+std::vector<Tokenizer::MappedFile *> images;
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE IMPL-----------------------------/
+ *---------------------------------------------------------------------*/
+
+static StringRef
+addString (std::string &strings, const std::string &value)
+{
+  StringRef ref{ (uint32_t)strings.size (), (uint32_t)value.size () };
+  strings += value;
+  return ref;
+}
+
+static size_t
+alignUp (size_t offset)
+{
+  return (offset + 15) & ~(size_t)15;
+}
+
+static bool
+isBound (const Interpreter::Func &func)
+{
+  if (func.program == nullptr) return false;
+  for (const Parser::SynNode &node : func.nodes)
+    if (node.val.type == Parser::AlgebraType::VARIABLE
+        && node.slot == Parser::NO_SLOT)
+      return false;
+  return !func.nodes.empty ();
+}
+
+//! \brief Check that an array of count T at offset lies before the strings
+template <typename T>
+static bool
+isArray (const Header &header, uint64_t offset, uint64_t count)
+{
+  return offset % alignof (T) == 0 && offset <= header.stringsOffset
+         && count <= (header.stringsOffset - offset) / sizeof (T);
+}
+
+//! \brief Check that a pool is in post order, its slots are arguments and
+//!        its values and operations are known
+static bool
+isValidPool (Parser::NodeSpan nodes, uint32_t argCount)
+{
+  using Parser::AlgebraType;
+  using Parser::OperationType;
+  for (size_t i = 0; i < nodes.size (); ++i)
+    {
+      const Parser::SynNode &node = nodes[i];
+      switch (node.val.type)
+        {
+        case AlgebraType::VALUE:
+          if (node.val.value > 1) return false;
+          break;
+        case AlgebraType::VARIABLE:
+          if (node.slot >= argCount) return false;
+          break;
+        case AlgebraType::OPERATION:
+          if (node.right >= i) return false;
+          switch (node.val.operation)
+            {
+            case OperationType::AND:
+            case OperationType::OR:
+              if (node.left >= i) return false;
+              break;
+            case OperationType::NOT: break;
+            default: return false;
+            }
+          break;
+        default: return false;
+        }
+    }
+  return !nodes.empty ();
+}
+} // end namespace
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE EXPR-----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Write the definitions of the program namespace to an image
+extern bool
+save (const char *fileName)
+{
+  std::vector<const Interpreter::Func *> funcs;
+  for (const auto &func : programNameSpace)
+    {
+      if (isBound (func))
+        funcs.push_back (&func);
+      else
+        std::cerr << "INFO: image skips " << Symbols::name (func.name)
+                  << ", it has no compiled definition\n";
+    }
+
+  std::vector<FunctionRecord> records;
+  std::vector<StringRef> arguments;
+  std::string strings;
+  size_t offset = sizeof (Header);
+  for (const auto *func : funcs)
+    offset += sizeof (FunctionRecord)
+              + func->argNames.size () * sizeof (StringRef);
+
+  for (const auto *func : funcs)
+    {
+      offset = alignUp (offset);
+      FunctionRecord record{};
+      record.name = addString (strings, Symbols::name (func->name));
+      record.argCount = func->argNames.size ();
+      record.argsIndex = arguments.size ();
+      record.nodesOffset = offset;
+      record.nodeCount = func->nodes.size ();
+      for (Symbols::Symbol arg : func->argNames)
+        arguments.push_back (addString (strings, Symbols::name (arg)));
+      offset += func->nodes.size () * sizeof (Parser::SynNode);
+      offset = alignUp (offset);
+      record.codeOffset = offset;
+      record.codeCount = func->program->code.size ();
+      record.maxStack = func->program->maxStack;
+      record.temps = func->program->temps;
+      records.push_back (record);
+      offset += func->program->code.size () * sizeof (Vm::Instruction);
+    }
+
+  Header header{};
+  memcpy (header.magic, imageMagic, sizeof (imageMagic));
+  header.version = imageVersion;
+  header.nodeSize = sizeof (Parser::SynNode);
+  header.functionCount = records.size ();
+  header.argumentCount = arguments.size ();
+  header.stringsOffset = offset;
+  header.stringsSize = strings.size ();
+
+  std::vector<char> image (offset + strings.size (), 0);
+  char *out = image.data ();
+  memcpy (out, &header, sizeof (header));
+  out += sizeof (header);
+  memcpy (out, records.data (), records.size () * sizeof (FunctionRecord));
+  out += records.size () * sizeof (FunctionRecord);
+  memcpy (out, arguments.data (), arguments.size () * sizeof (StringRef));
+  for (size_t i = 0; i < funcs.size (); ++i)
+    {
+      // Symbols are process local, bound leaves only need their slot
+      auto *nodes = reinterpret_cast<Parser::SynNode *> (
+          image.data () + records[i].nodesOffset);
+      std::copy (funcs[i]->nodes.begin (), funcs[i]->nodes.end (), nodes);
+      for (size_t n = 0; n < records[i].nodeCount; ++n)
+        nodes[n].val.variable = Symbols::NONE;
+      std::copy (funcs[i]->program->code.begin (),
+                 funcs[i]->program->code.end (),
+                 reinterpret_cast<Vm::Instruction *> (
+                     image.data () + records[i].codeOffset));
+    }
+  memcpy (image.data () + offset, strings.data (), strings.size ());
+
+  FILE *file = fopen (fileName, "wb");
+  if (file == nullptr)
+    {
+      std::cerr << "ERROR: could not open image: " << fileName << '\n';
+      return false;
+    }
+  bool written
+      = fwrite (image.data (), 1, image.size (), file) == image.size ();
+  written = fclose (file) == 0 && written;
+  if (!written)
+    std::cerr << "ERROR: could not write image: " << fileName << '\n';
+  return written;
+}
+
+//! \brief Map an image and add its definitions to the program namespace
+extern bool
+load (const char *fileName)
+{
+  Tokenizer::MappedFile *mapped = Tokenizer::mapFile (fileName);
+  if (mapped == nullptr)
+    {
+      std::cerr << "ERROR: could not open image: " << fileName << '\n';
+      return false;
+    }
+
+  const char *data = mapped->data;
+  const Header *header = reinterpret_cast<const Header *> (data);
+  size_t tablesEnd = sizeof (Header);
+  if (mapped->size >= sizeof (Header))
+    tablesEnd += header->functionCount * sizeof (FunctionRecord)
+                 + header->argumentCount * sizeof (StringRef);
+  if (mapped->size < sizeof (Header)
+      || memcmp (header->magic, imageMagic, sizeof (imageMagic)) != 0
+      || header->version != imageVersion
+      || header->nodeSize != sizeof (Parser::SynNode)
+      || tablesEnd > mapped->size || header->stringsOffset > mapped->size
+      || header->stringsSize > mapped->size - header->stringsOffset)
+    {
+      std::cerr << "ERROR: " << fileName
+                << " is not a compatible namespace image\n";
+      delete mapped;
+      return false;
+    }
+
+  const auto *records
+      = reinterpret_cast<const FunctionRecord *> (data + sizeof (Header));
+  const auto *arguments = reinterpret_cast<const StringRef *> (
+      records + header->functionCount);
+  const char *strings = data + header->stringsOffset;
+  auto string = [&] (StringRef ref) -> std::string_view {
+    if (ref.offset > header->stringsSize
+        || ref.length > header->stringsSize - ref.offset)
+      return {};
+    return { strings + ref.offset, ref.length };
+  };
+
+  // Validate every definition before any of them becomes visible
+  std::vector<Interpreter::Func> funcs;
+  for (uint32_t i = 0; i < header->functionCount; ++i)
+    {
+      const FunctionRecord &record = records[i];
+      bool inBounds
+          = record.argsIndex <= header->argumentCount
+            && record.argCount <= header->argumentCount - record.argsIndex
+            && isArray<Parser::SynNode> (*header, record.nodesOffset,
+                                         record.nodeCount)
+            && isArray<Vm::Instruction> (*header, record.codeOffset,
+                                         record.codeCount)
+            // Every stack slot is pushed and every temp stored by code
+            && record.maxStack <= record.codeCount
+            && record.temps <= record.codeCount;
+      Parser::NodeSpan nodes;
+      Vm::Program *program = new Vm::Program;
+      if (inBounds)
+        {
+          nodes = Parser::NodeSpan (reinterpret_cast<const Parser::SynNode *> (
+                                        data + record.nodesOffset),
+                                    record.nodeCount);
+          program->inputs = record.argCount;
+          program->maxStack = record.maxStack;
+          program->temps = record.temps;
+          program->code = std::span<const Vm::Instruction> (
+              reinterpret_cast<const Vm::Instruction *> (data
+                                                         + record.codeOffset),
+              record.codeCount);
+        }
+      if (!inBounds || !isValidPool (nodes, record.argCount)
+          || !Vm::isValid (*program))
+        {
+          delete program;
+          for (auto &func : funcs)
+            delete func.program;
+          std::cerr << "ERROR: " << fileName
+                    << " holds a corrupt definition\n";
+          delete mapped;
+          return false;
+        }
+
+      Interpreter::Func func{ Symbols::intern (string (record.name)),
+                              {},
+                              nullptr };
+      for (uint32_t a = 0; a < record.argCount; ++a)
+        func.argNames.push_back (
+            Symbols::intern (string (arguments[record.argsIndex + a])));
+      func.nodes = nodes;
+      func.program = program;
+      funcs.push_back (func);
+    }
+
+  for (auto &func : funcs)
+    Interpreter::define (func);
+
+  images.push_back (mapped);
+  return true;
+}
+} // end namespace Image
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
@@ -9,16 +9,37 @@
  *---------------------------------------------------------------------*/
 
 #include "interpreter.hpp"
+#include "aig.hpp"
+#include "bdd.hpp"
+#include "jit.hpp"
+#include "minimize.hpp"
+#include "packed.hpp"
 #include "parser.hpp"
+#include "simplify.hpp"
 #include "tokenizer.hpp"
+#include "vm.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <mutex>
 #include <optional>
+#include <sys/uio.h>
+#include <thread>
+#include <unistd.h>
 
 /*----------------------------------------------------------------------/
  *--------------------------FOREIGN GLOBALS-----------------------------/
  *---------------------------------------------------------------------*/
 
 std::vector<Interpreter::Func> programNameSpace;
+Interpreter::Options programOptions;
 
 namespace Interpreter
 {
@@ -28,65 +49,133 @@ namespace // Helper functions
  *------------------------------MODULE IMPL-----------------------------/
  *---------------------------------------------------------------------*/
 
+//! \brief Evaluate a syntax tree without recursion
+//! \details The pool is in post order, so one forward sweep computes every
+//!          node after its children, whatever the nesting depth.
 std::optional<unsigned char>
-evaluateSynTree (Parser::SynTree *node,
-                 const std::vector<std::string> &argNames,
+evaluateSynTree (Parser::NodeSpan tree,
                  const std::vector<unsigned char> &values)
 {
   using Parser::Algebra;
   using Parser::AlgebraType;
   using Parser::OperationType;
 
-  if (!node) return 0;
+  if (tree.empty ()) return 0;
 
-  if (node->val.type == AlgebraType::VALUE)
-    {
-      return node->val.value;
-    }
+  static thread_local std::vector<unsigned char> nodeValues;
+  nodeValues.resize (tree.size ());
+  bool failed = false;
 
-  else if (node->val.type == AlgebraType::OPERATION)
+  for (size_t index = 0; index < tree.size (); ++index)
     {
-      auto leftValueOpt = evaluateSynTree (node->left, argNames, values);
-      auto rightValueOpt = evaluateSynTree (node->right, argNames, values);
-
-      if (!leftValueOpt || !rightValueOpt) return std::nullopt;
+      const Parser::SynNode *node = &tree[index];
+      unsigned char &result = nodeValues[index];
 
-      unsigned char leftValue = leftValueOpt.value ();
-      unsigned char rightValue = rightValueOpt.value ();
-
-      switch (node->val.operation)
+      if (node->val.type == AlgebraType::VALUE)
         {
-        case OperationType::AND: return leftValue & rightValue;
-        case OperationType::OR : return leftValue | rightValue;
-        case OperationType::NOT: return !rightValue;
-        default                : return std::nullopt;
+          result = node->val.value;
         }
-    }
-  else if (node->val.type == AlgebraType::VARIABLE)
-    {
-      for (size_t i = 0; i < argNames.size (); ++i)
+      else if (node->val.type == AlgebraType::OPERATION)
+        {
+          unsigned char rightValue = nodeValues[node->right];
+          switch (node->val.operation)
+            {
+            case OperationType::AND:
+              result = nodeValues[node->left] & rightValue;
+              break;
+            case OperationType::OR:
+              result = nodeValues[node->left] | rightValue;
+              break;
+            case OperationType::NOT: result = !rightValue; break;
+            }
+        }
+      else if (node->val.type == AlgebraType::VARIABLE)
+        {
+          if (node->slot != Parser::NO_SLOT)
+            {
+              result = values[node->slot];
+            }
+          else
+            {
+              std::cerr << "EVALUATION ERROR: Variable "
+                        << Symbols::name (node->val.variable)
+                        << " not found.\n";
+              result = 0;
+              failed = true;
+            }
+        }
+      else
         {
-          if (argNames[i] == node->val.variable) return values[i];
+          return std::nullopt;
         }
-      std::cerr << "EVALUATION ERROR: Variable " << node->val.variable
-                << " not found.\n";
-      return std::nullopt;
     }
 
-  return std::nullopt;
+  if (failed) return std::nullopt;
+  return nodeValues[tree.size () - 1];
 }
 
+//! \brief Report a compiled result that differs from the tree walker
 static void
-evaluateAndPrintAll (const std::string &name,
-                     const std::vector<std::string> &arguments,
-                     Parser::SynTree *definition)
+verify (const Func &func, const std::vector<unsigned char> &values,
+        unsigned char result)
 {
-  std::vector<std::string> argNames = arguments;
+  if (func.nodes.empty ()) return; // A loaded truth table has no tree
+  // The parsed tree, so a wrong rewrite of the simplifier shows up too
+  auto expected = evaluateSynTree (func.reference != nullptr
+                                       ? Parser::NodeSpan (
+                                           func.reference->nodes)
+                                       : func.nodes,
+                                   values);
+  if (expected == result) return;
+
+  std::cerr << "VERIFY ERROR: " << Symbols::name (func.name) << '(';
+  for (size_t i = 0; i < values.size (); ++i)
+    std::cerr << (i > 0 ? ", " : "") << static_cast<int> (values[i]);
+  std::cerr << ") evaluated to " << static_cast<int> (result) << " instead of "
+            << static_cast<int> (expected.value_or (2)) << '\n';
+}
+
+//! \brief Evaluate a function with the best representation it has
+//! \details With the verify option the compiled result is checked against
+//!          the tree walker, which stays the reference implementation.
+static std::optional<unsigned char>
+evaluate (const Func &func, const std::vector<unsigned char> &values)
+{
+  unsigned char result;
+  if (func.table != nullptr)
+    result = func.table->lookup (values.data ());
+  else if (func.bdd != Bdd::NONE)
+    result = Bdd::evaluate (func.bdd, values);
+  else if (func.program != nullptr)
+    result = Vm::run (*func.program, values);
+  else if (func.aig != nullptr)
+    result = Aig::evaluate (*func.aig, values);
+  else
+    return evaluateSynTree (func.nodes, values);
+
+  if (programOptions.verify) verify (func, values, result);
+  return result;
+}
+
+//! \brief Check if single assignments are answered without the bytecode
+//! \details A table lookup or a BDD path is cheaper than filling a block
+//!          of bit-sliced words for one row.
+static bool
+hasLookup (const Func &func)
+{
+  return func.table != nullptr || func.bdd != Bdd::NONE;
+}
+
+//! \brief Print every row of the truth table, one evaluation per row
+//! \details Only used for definitions without a program or with too many
+//!          arguments to bit-slice the rows.
+static void
+evaluateAndPrintEach (const Func &func)
+{
+  const std::vector<Symbols::Symbol> &argNames = func.argNames;
   size_t numArgs = argNames.size ();
   std::vector<unsigned char> argumentValues (numArgs, 0);
 
-  std::cout << "EVALUATION ALL: " << name << "\n";
-
   // Generate all possible combinations of values for the arguments
   bool finished = false;
   while (!finished)
@@ -99,7 +188,7 @@ evaluateAndPrintAll (const std::string &name,
         }
 
       // Evaluate the definition with current argument values
-      auto resultOpt = evaluateSynTree (definition, argNames, argumentValues);
+      auto resultOpt = evaluate (func, argumentValues);
 
       if (resultOpt)
         {
@@ -111,7 +200,7 @@ evaluateAndPrintAll (const std::string &name,
           for (size_t i = 0; i < numArgs; ++i)
             {
               if (i > 0) std::cerr << ", ";
-              std::cerr << argNames[i] << "="
+              std::cerr << Symbols::name (argNames[i]) << "="
                         << static_cast<int> (argumentValues[i]);
             }
           std::cerr << ")\n";
@@ -137,62 +226,962 @@ evaluateAndPrintAll (const std::string &name,
     }
 }
 
-static std::string
-constructMinterm (const std::vector<unsigned char> &row, size_t N)
+//! \brief 64-bit words of assignments evaluated by one runBlock
+static uint32_t
+blockWords (const Func &func)
+{
+  return func.jit != nullptr ? 1 : Vm::widestKernel ().words;
+}
+
+//! \brief Evaluate blockWords (func) * 64 bit-sliced assignments
+//! \details The machine code is preferred, the widest bytecode kernel is
+//!          the fallback.
+static void
+runBlock (const Func &func, const uint64_t *inputs, uint64_t *results)
+{
+  if (func.jit != nullptr)
+    results[0] = Jit::run (*func.jit, inputs);
+  else
+    Vm::widestKernel ().run (*func.program, inputs, results);
+}
+
+//! \brief Rows of the truth table one task of ALL formats
+//! \details A multiple of the rows of any block, so a task never splits one.
+constexpr uint64_t allTaskRows = 1 << 14;
+
+//! \brief Evaluate the rows [first, first + count) in Gray code order
+//! \details Each word holds 64 rows, which only differ in the six last
+//!          inputs. Stepping through the words in Gray code order flips one
+//!          other input per word, so only its cone is evaluated again. The
+//!          words are stored in row order.
+static void
+evaluateGray (const Func &func, uint64_t first, uint64_t count,
+              uint64_t *bits)
+{
+  uint32_t numArgs = func.argNames.size ();
+  std::vector<uint64_t> inputs (numArgs);
+  std::vector<uint64_t> values (func.nodes.size ());
+  for (uint32_t i = 0; i < numArgs; ++i)
+    inputs[i] = Vm::sliceInput (i, numArgs, first);
+  bits[0] = Vm::evaluateNodes (func.nodes, inputs.data (), values.data ());
+
+  uint64_t words = (count + Vm::sliceLanes - 1) / Vm::sliceLanes;
+  for (uint64_t step = 1; step < words; ++step)
+    {
+      // Word step of the Gray code differs from the last in one row bit
+      uint32_t bit = std::countr_zero (step) + 6;
+      uint32_t input = numArgs - 1 - bit;
+      inputs[input] = ~inputs[input];
+      bits[step ^ (step >> 1)]
+          = Vm::evaluateCone (func.nodes, *func.cones, input, inputs.data (),
+                              values.data ());
+    }
+}
+
+//! \brief Evaluate the rows [first, first + count), in bit r % 64 of word
+//!        r / 64 for row first + r
+//! \details The results are bit-sliced, one runBlock evaluates 64 rows per
+//!          word with input words generated from the row counter. With
+//!          cones the words are evaluated in Gray code order, so count must
+//!          be a power of two and first a multiple of it.
+//! \return results, or the stored bits of a tabulated function
+static const uint64_t *
+evaluateRows (const Func &func, uint64_t first, uint64_t count,
+              std::vector<uint64_t> &results)
+{
+  if (func.table != nullptr)
+    return func.table->bits.data () + first / Vm::sliceLanes;
+
+  if (func.cones != nullptr)
+    {
+      results.resize ((count + Vm::sliceLanes - 1) / Vm::sliceLanes);
+      evaluateGray (func, first, count, results.data ());
+      return results.data ();
+    }
+
+  size_t numArgs = func.argNames.size ();
+  uint32_t words = blockWords (func);
+  uint64_t blockRows = uint64_t (words) * Vm::sliceLanes;
+  std::vector<uint64_t> inputs (numArgs * words);
+  results.resize ((count + blockRows - 1) / blockRows * words);
+  for (uint64_t block = first; block < first + count; block += blockRows)
+    {
+      Vm::sliceBlock (numArgs, words, block,
+                      block == first ? ~block : block - blockRows,
+                      inputs.data ());
+      runBlock (func, inputs.data (),
+                results.data () + (block - first) / Vm::sliceLanes);
+    }
+  return results.data ();
+}
+
+//! \brief Format the rows [first, first + count) of the truth table
+static void
+formatRows (const Func &func, uint64_t first, uint64_t count,
+            std::string &text)
+{
+  size_t numArgs = func.argNames.size ();
+  std::vector<uint64_t> results;
+  const uint64_t *bits = evaluateRows (func, first, count, results);
+
+  // Columns of the last lowArgs inputs, pre-rendered for every value
+  size_t lowArgs = std::min<size_t> (numArgs, 8);
+  size_t highWidth = 2 * (numArgs - lowArgs), lowWidth = 2 * lowArgs;
+  uint64_t lowMask = (uint64_t (1) << lowArgs) - 1;
+  std::string lows ((lowMask + 1) * lowWidth, '|');
+  for (uint64_t low = 0; low <= lowMask; ++low)
+    for (size_t i = 0; i < lowArgs; ++i)
+      lows[low * lowWidth + 2 * i] = '0' + ((low >> (lowArgs - 1 - i)) & 1);
+
+  size_t rowWidth = highWidth + lowWidth + 2;
+  text.resize (count * rowWidth);
+  char *out = text.data ();
+  std::vector<unsigned char> values (numArgs);
+  for (uint64_t lane = 0; lane < count; ++lane, out += rowWidth)
+    {
+      uint64_t row = first + lane;
+      if (lane == 0 || (row & lowMask) == 0)
+        for (size_t i = 0; i < numArgs - lowArgs; ++i)
+          {
+            out[2 * i] = '0' + ((row >> (numArgs - 1 - i)) & 1);
+            out[2 * i + 1] = '|';
+          }
+      else
+        std::memcpy (out, out - rowWidth, highWidth);
+      std::memcpy (out + highWidth, lows.data () + (row & lowMask) * lowWidth,
+                   lowWidth);
+      unsigned char result
+          = (bits[lane / Vm::sliceLanes] >> (lane % Vm::sliceLanes)) & 1;
+      out[rowWidth - 2] = '0' + result;
+      out[rowWidth - 1] = '\n';
+
+      if (programOptions.verify)
+        {
+          for (size_t i = 0; i < numArgs; ++i)
+            values[i] = (row >> (numArgs - 1 - i)) & 1;
+          verify (func, values, result);
+        }
+    }
+}
+
+//! \brief Write every byte of the buffers, resuming after partial writes
+//! \return false if the output failed, a closed pipe for instance
+static bool
+writeAll (int fd, iovec *buffers, int count)
+{
+  while (count > 0)
+    {
+      ssize_t written = writev (fd, buffers, count);
+      if (written < 0)
+        {
+          if (errno == EINTR) continue;
+          return false;
+        }
+      for (; count > 0 && size_t (written) >= buffers->iov_len; --count)
+        written -= (buffers++)->iov_len;
+      if (count > 0)
+        {
+          buffers->iov_base = static_cast<char *> (buffers->iov_base) + written;
+          buffers->iov_len -= written;
+        }
+    }
+  return true;
+}
+
+//! \brief Print every row of the truth table
+//! \details The rows are split into tasks of allTaskRows, formatted into a
+//!          ring of reusable buffers. The main thread and the other -j
+//!          threads each claim the next unformatted task, so a slow task
+//!          holds back no other thread. A writer thread hands the formatted
+//!          tasks to writev in row order, so no evaluation waits for the
+//!          terminal or a pipe unless the whole ring is formatted ahead.
+//!          Needs fewer than 64 arguments, so the row counter fits a word.
+static void
+evaluateAndPrintAll (const Func &func)
+{
+  size_t numArgs = func.argNames.size ();
+  std::cout << "EVALUATION ALL: " << Symbols::name (func.name) << "\n";
+
+  if ((func.program == nullptr && func.table == nullptr) || numArgs >= 64)
+    {
+      evaluateAndPrintEach (func);
+      return;
+    }
+
+  uint64_t rows = uint64_t (1) << numArgs;
+  uint64_t tasks = (rows + allTaskRows - 1) / allTaskRows;
+  unsigned threads = std::min<uint64_t> (programOptions.threads, tasks);
+
+  // Formatted tasks wait in the ring until every earlier one is written
+  size_t ring = 4 * threads;
+  std::vector<std::string> texts (ring);
+  std::vector<bool> ready (ring, false);
+  std::mutex mutex;
+  std::condition_variable changed;
+  uint64_t claimed = 0, written = 0;
+
+  auto format = [&] () {
+    for (;;)
+      {
+        uint64_t task;
+        {
+          std::unique_lock<std::mutex> lock (mutex);
+          changed.wait (lock, [&] () {
+            return claimed >= tasks || claimed < written + ring;
+          });
+          if (claimed >= tasks) return;
+          task = claimed++;
+        }
+        // The slot stays with this thread until it is marked ready
+        uint64_t first = task * allTaskRows;
+        formatRows (func, first, std::min (rows - first, allTaskRows),
+                    texts[task % ring]);
+        {
+          std::lock_guard<std::mutex> lock (mutex);
+          ready[task % ring] = true;
+        }
+        changed.notify_all ();
+      }
+  };
+
+  std::cout.flush ();
+  std::thread writer ([&] () {
+    bool failed = false;
+    std::vector<iovec> buffers;
+    for (uint64_t task = 0; task < tasks;)
+      {
+        // Gather the consecutive tasks already formatted
+        buffers.clear ();
+        {
+          std::unique_lock<std::mutex> lock (mutex);
+          changed.wait (lock, [&] () { return bool (ready[task % ring]); });
+          for (uint64_t next = task;
+               next < tasks && next < task + ring && ready[next % ring]
+               && buffers.size () < IOV_MAX;
+               ++next)
+            buffers.push_back ({ texts[next % ring].data (),
+                                 texts[next % ring].size () });
+        }
+        if (!failed)
+          failed = !writeAll (STDOUT_FILENO, buffers.data (), buffers.size ());
+        {
+          std::lock_guard<std::mutex> lock (mutex);
+          for (size_t i = 0; i < buffers.size (); ++i, ++task)
+            ready[task % ring] = false;
+          written = task;
+        }
+        changed.notify_all ();
+      }
+  });
+
+  std::vector<std::thread> workers;
+  for (unsigned t = 1; t < threads; ++t)
+    workers.emplace_back (format);
+  format ();
+  for (auto &worker : workers)
+    worker.join ();
+  writer.join ();
+}
+
+//! \brief Print how many rows output 1, with popcounts over the results
+//! \details A function with a BDD counts its paths instead. Otherwise the
+//!          -j threads each claim the next chunk of rows, nothing is
+//!          formatted.
+static void
+countAll (const Func &func)
+{
+  size_t numArgs = func.argNames.size ();
+  uint64_t rows = uint64_t (1) << numArgs;
+  uint64_t ones = 0;
+
+  if (func.bdd != Bdd::NONE && numArgs <= 53)
+    {
+      ones = Bdd::satCount (func.bdd, numArgs); // Exact below 2^53
+    }
+  else
+    {
+      uint64_t chunks = (rows + Packed::chunkRows - 1) / Packed::chunkRows;
+      unsigned threads = std::min<uint64_t> (programOptions.threads, chunks);
+      std::atomic<uint64_t> next = 0, total = 0;
+      auto count = [&] () {
+        std::vector<uint64_t> results;
+        uint64_t local = 0;
+        for (uint64_t chunk; (chunk = next++) < chunks;)
+          {
+            uint64_t first = chunk * Packed::chunkRows;
+            uint64_t length = std::min (rows - first, Packed::chunkRows);
+            const uint64_t *bits
+                = evaluateRows (func, first, length, results);
+            for (uint64_t w = 0; w < length / Vm::sliceLanes; ++w)
+              local += std::popcount (bits[w]);
+            if (length < Vm::sliceLanes)
+              local += std::popcount (bits[0]
+                                      & ((uint64_t (1) << length) - 1));
+          }
+        total += local;
+      };
+
+      std::vector<std::thread> workers;
+      for (unsigned t = 1; t < threads; ++t)
+        workers.emplace_back (count);
+      count ();
+      for (auto &worker : workers)
+        worker.join ();
+      ones = total;
+    }
+
+  std::cout << "EVALUATION COUNT: " << Symbols::name (func.name) << ": "
+            << ones << " of " << rows << " rows, density "
+            << double (ones) / double (rows) << '\n';
+}
+
+//! \brief Print the first limit rows that output 1, in ALL order
+//! \details Rows are evaluated one task at a time and the set bits found
+//!          with countr_zero, so the search stops with the last row found.
+static void
+printFirst (const Func &func, uint64_t limit)
+{
+  size_t numArgs = func.argNames.size ();
+  uint64_t rows = uint64_t (1) << numArgs;
+  std::cout << "EVALUATION FIRST: " << Symbols::name (func.name) << '\n';
+
+  std::vector<uint64_t> results;
+  std::string text;
+  for (uint64_t first = 0; first < rows && limit > 0; first += allTaskRows)
+    {
+      uint64_t count = std::min (rows - first, allTaskRows);
+      const uint64_t *bits = evaluateRows (func, first, count, results);
+      for (uint64_t w = 0; w * Vm::sliceLanes < count && limit > 0; ++w)
+        {
+          uint64_t word = bits[w];
+          if (count - w * Vm::sliceLanes < Vm::sliceLanes)
+            word &= (uint64_t (1) << (count - w * Vm::sliceLanes)) - 1;
+          for (; word != 0 && limit > 0; word &= word - 1, --limit)
+            {
+              uint64_t row = first + w * Vm::sliceLanes
+                             + std::countr_zero (word);
+              for (size_t i = 0; i < numArgs; ++i)
+                {
+                  text += '0' + ((row >> (numArgs - 1 - i)) & 1);
+                  text += '|';
+                }
+              text += "1\n";
+            }
+        }
+    }
+  std::cout << text;
+}
+
+//! \brief Write the truth table bit-packed into a file
+//! \details Rows are evaluated one chunk at a time, so memory stays bounded
+//!          whatever the number of arguments.
+static void
+saveAll (const Func &func, const std::string &fileName)
 {
-  std::string minterm;
-  for (size_t i = 0; i < N; ++i)
+  if (func.program == nullptr && func.table == nullptr)
     {
-      if (row[i] == 0) minterm += "!";
-      minterm += 'a' + i;
-      if (i < N - 1) minterm += " & ";
+      std::cerr << "EVALUATION ERROR: " << Symbols::name (func.name)
+                << " can not be written as a truth table\n";
+      return;
     }
-  return minterm;
+
+  auto start = std::chrono::steady_clock::now ();
+  std::vector<uint64_t> results;
+  bool saved = Packed::save (
+      fileName.c_str (), func.argNames,
+      [&] (uint64_t first, uint64_t count, uint64_t *bits) {
+        const uint64_t *rows = evaluateRows (func, first, count, results);
+        std::copy (rows, rows + (count + Vm::sliceLanes - 1) / Vm::sliceLanes,
+                   bits);
+      });
+  if (!saved) return;
+
+  std::chrono::duration<double> elapsed
+      = std::chrono::steady_clock::now () - start;
+  std::cerr << "INFO: ALL " << Symbols::name (func.name) << ": "
+            << (uint64_t (1) << func.argNames.size ()) << " rows in "
+            << elapsed.count () << " s, written to " << fileName << '\n';
 }
 
-static std::pair<std::string, std::vector<std::string> >
-getBooleanExpression (const Parser::Table &table)
+//! \brief Reader of the input vectors of a batch RUN file
+//! \details A file ending in .bin holds packed records of (inputs + 7) / 8
+//!          bytes, input i in bit i % 8 of byte i / 8. Any other file is
+//!          CSV, one vector of 0 and 1 per line.
+struct VectorReader
 {
-  std::vector<std::string> minterms;
-  std::vector<std::string> variables;
+  const char *data;
+  const char *end;
+  size_t inputs;
+  bool binary;
+  size_t count = 0; // Vectors read so far
+  bool failed = false;
+
+  //! \brief Read the next vector into values, false at the end or on error
+  bool
+  next (unsigned char *values)
+  {
+    if (binary)
+      {
+        size_t recordSize = (inputs + 7) / 8;
+        if (data == end) return false;
+        if (size_t (end - data) < recordSize) return fail ("is truncated");
+        for (size_t i = 0; i < inputs; ++i)
+          values[i] = (data[i / 8] >> (i % 8)) & 1;
+        data += recordSize;
+        ++count;
+        return true;
+      }
+
+    // Skip empty lines
+    while (data < end && (*data == '\n' || *data == '\r'))
+      ++data;
+    if (data == end) return false;
+
+    size_t found = 0;
+    for (; data < end && *data != '\n'; ++data)
+      {
+        char c = *data;
+        if (c == '0' || c == '1')
+          {
+            if (found == inputs) return fail ("has too many values");
+            values[found++] = c - '0';
+          }
+        else if (c != ',' && c != ' ' && c != '\t' && c != '\r')
+          {
+            return fail ("has a value other than 0 or 1");
+          }
+      }
+    if (found != inputs) return fail ("has too few values");
+    ++count;
+    return true;
+  }
 
-  // Populate the variable names
-  for (size_t i = 0; i < table.N; ++i)
+  bool
+  fail (const char *reason)
+  {
+    std::cerr << "EVALUATION ERROR: input vector " << count + 1 << ' '
+              << reason << '\n';
+    failed = true;
+    return false;
+  }
+};
+
+//! \brief Evaluate every vector of a batch RUN file, results in order
+//! \details Vectors are transposed straight into bit-sliced input words
+//!          and evaluated one block at a time with runBlock. The
+//!          throughput is reported on stderr.
+static void
+evaluateFile (const Func &func, const std::string &fileName)
+{
+  Tokenizer::MappedFile *file = Tokenizer::mapFile (fileName.c_str ());
+  if (file == nullptr)
     {
-      variables.push_back (std::string (1, 'a' + i));
+      std::cerr << "ERROR: could not open file: " << fileName << '\n';
+      return;
     }
 
-  // Construct minterms
-  for (size_t i = 0; i < table.M; ++i)
+  auto start = std::chrono::steady_clock::now ();
+  size_t numArgs = func.argNames.size ();
+  bool binary = fileName.ends_with (".bin");
+  VectorReader reader{ file->data, file->data + file->size, numArgs, binary };
+  std::cout << "EVALUATION RUN: " << Symbols::name (func.name) << '\n';
+
+  if (func.program == nullptr || hasLookup (func))
+    {
+      std::vector<unsigned char> values (numArgs);
+      while (reader.next (values.data ()))
+        {
+          std::optional<unsigned char> answer = evaluate (func, values);
+          if (answer.has_value ())
+            std::cout << static_cast<int> (answer.value ()) << '\n';
+        }
+    }
+  else
     {
-      if (table.output[i] == 1)
+      uint32_t words = blockWords (func);
+      size_t blockRows = size_t (words) * Vm::sliceLanes;
+      std::vector<uint64_t> inputs (numArgs * words);
+      std::vector<uint64_t> results (words);
+      std::vector<unsigned char> rows (blockRows * numArgs);
+      std::vector<unsigned char> values (numArgs);
+      std::string block;
+
+      for (;;)
         {
-          std::vector<unsigned char> row (table.input.begin () + i * table.N,
-                                          table.input.begin ()
-                                              + (i + 1) * table.N);
-          minterms.push_back (constructMinterm (row, table.N));
+          size_t lanes = 0;
+          while (lanes < blockRows
+                 && reader.next (rows.data () + lanes * numArgs))
+            ++lanes;
+          if (lanes == 0) break;
+
+          std::fill (inputs.begin (), inputs.end (), 0);
+          for (size_t lane = 0; lane < lanes; ++lane)
+            for (size_t slot = 0; slot < numArgs; ++slot)
+              inputs[slot * words + lane / Vm::sliceLanes]
+                  |= uint64_t (rows[lane * numArgs + slot])
+                     << (lane % Vm::sliceLanes);
+          runBlock (func, inputs.data (), results.data ());
+
+          block.clear ();
+          for (size_t lane = 0; lane < lanes; ++lane)
+            {
+              unsigned char result = (results[lane / Vm::sliceLanes]
+                                      >> (lane % Vm::sliceLanes))
+                                     & 1;
+              block += '0' + result;
+              block += '\n';
+              if (programOptions.verify)
+                {
+                  values.assign (rows.begin () + lane * numArgs,
+                                 rows.begin () + (lane + 1) * numArgs);
+                  verify (func, values, result);
+                }
+            }
+          std::cout << block;
+          if (lanes < blockRows) break;
         }
     }
 
-  // Combine minterms into an expression
+  std::chrono::duration<double> elapsed
+      = std::chrono::steady_clock::now () - start;
+  std::cerr << "INFO: RUN " << Symbols::name (func.name) << ": "
+            << reader.count << " vectors in " << elapsed.count ()
+            << " s, " << reader.count / elapsed.count () << " vectors/s\n";
+  delete file;
+}
+
+//! \brief Consecutive RUN commands of one function, evaluated together
+struct RunBatch
+{
+  const Func *func = nullptr;
+  std::vector<std::vector<unsigned char> > rows;
+};
+
+RunBatch pendingRuns;
+
+//! \brief Report every variable of a tree that names no argument, once
+static void
+reportUnbound (const Parser::SynTree &tree, Symbols::Symbol definition)
+{
+  std::vector<Symbols::Symbol> reported;
+  for (const Parser::SynNode &node : tree.nodes)
+    {
+      if (node.val.type != Parser::AlgebraType::VARIABLE
+          || node.slot != Parser::NO_SLOT
+          || std::find (reported.begin (), reported.end (),
+                        node.val.variable)
+                 != reported.end ())
+        continue;
+      reported.push_back (node.val.variable);
+      std::cerr << "SYNTAX ERROR: variable "
+                << Symbols::name (node.val.variable)
+                << " is not an argument of " << Symbols::name (definition)
+                << '\n';
+    }
+}
+
+//! \brief Rows of a FIND table that output 1, one cube per row
+static std::vector<Minimize::Cube>
+onSet (const Parser::Table &table)
+{
+  std::vector<Minimize::Cube> cubes;
+  uint64_t all = table.N >= 64 ? ~0ull : (uint64_t (1) << table.N) - 1;
+  for (size_t row = 0; row < table.M; ++row)
+    {
+      if (table.output[row] != 1) continue;
+      uint64_t value = 0;
+      for (size_t i = 0; i < table.N; ++i)
+        value |= uint64_t (table.input[row * table.N + i] != 0) << i;
+      cubes.push_back ({ all, value });
+    }
+  return cubes;
+}
+
+//! \brief Rows of a truth table that output 1, one cube per row
+//! \details Rows number the first input as their highest bit, cubes as
+//!          their lowest.
+static std::vector<Minimize::Cube>
+onSet (const Vm::TruthTable &table)
+{
+  std::vector<Minimize::Cube> cubes;
+  uint64_t all = (uint64_t (1) << table.inputs) - 1;
+  uint64_t rows = uint64_t (1) << table.inputs;
+  for (uint64_t row = 0; row < rows; ++row)
+    {
+      if (!((table.bits[row / 64] >> (row % 64)) & 1)) continue;
+      uint64_t value = 0;
+      for (uint32_t i = 0; i < table.inputs; ++i)
+        value |= ((row >> (table.inputs - 1 - i)) & 1) << i;
+      cubes.push_back ({ all, value });
+    }
+  return cubes;
+}
+
+//! \brief Name FIND gives input i
+static std::string
+inputName (size_t i)
+{
+  return std::string (1, 'a' + i);
+}
+
+//! \brief Text of a sum of products, as FIND prints it
+static std::string
+formatSumOfProducts (const std::vector<Minimize::Cube> &cubes,
+                     size_t inputs)
+{
+  if (cubes.empty ()) return "0";
   std::string expression;
-  for (size_t i = 0; i < minterms.size (); ++i)
+  for (const Minimize::Cube &cube : cubes)
+    {
+      if (!expression.empty ()) expression += " | ";
+      std::string product;
+      for (size_t i = 0; i < inputs; ++i)
+        {
+          if (!((cube.care >> i) & 1)) continue;
+          if (!product.empty ()) product += " & ";
+          if (!((cube.value >> i) & 1)) product += '!';
+          product += inputName (i);
+        }
+      expression += "(" + (product.empty () ? "1" : product) + ")";
+    }
+  return expression;
+}
+
+//! \brief Append a sum of products to a node pool, shaped as the parser
+//!        would build it from formatSumOfProducts
+//! \param leaf node of input i, pushed or shared as the caller likes
+//! \return the node of the sum
+static Parser::NodeIndex
+appendSumOfProducts (Parser::SynTree &tree,
+                     const std::vector<Minimize::Cube> &cubes, size_t inputs,
+                     const std::function<Parser::NodeIndex (size_t)> &leaf)
+{
+  using Parser::Algebra;
+  using Parser::AlgebraType;
+  using Parser::NodeIndex;
+  using Parser::OperationType;
+
+  auto value = [&] (unsigned char constant) {
+    Algebra val;
+    val.type = AlgebraType::VALUE;
+    val.value = constant;
+    return tree.push (val);
+  };
+  auto operation = [&] (OperationType op, NodeIndex left, NodeIndex right) {
+    Algebra val;
+    val.type = AlgebraType::OPERATION;
+    val.operation = op;
+    return tree.push (val, left, right);
+  };
+
+  if (cubes.empty ()) return value (0);
+  NodeIndex sum = Parser::NO_NODE;
+  for (const Minimize::Cube &cube : cubes)
+    {
+      NodeIndex product = Parser::NO_NODE;
+      for (size_t i = 0; i < inputs; ++i)
+        {
+          if (!((cube.care >> i) & 1)) continue;
+          NodeIndex literal = leaf (i);
+          if (!((cube.value >> i) & 1))
+            literal = operation (OperationType::NOT, Parser::NO_NODE,
+                                 literal);
+          product = product == Parser::NO_NODE
+                        ? literal
+                        : operation (OperationType::AND, product, literal);
+        }
+      if (product == Parser::NO_NODE) product = value (1);
+      sum = sum == Parser::NO_NODE
+                ? product
+                : operation (OperationType::OR, sum, product);
+    }
+  return sum;
+}
+
+//! \brief Syntax tree of a sum of products over named arguments
+static Parser::SynTree *
+sumOfProducts (const std::vector<Minimize::Cube> &cubes, size_t inputs,
+               const std::vector<Symbols::Symbol> &arguments)
+{
+  Parser::SynTree *tree = new Parser::SynTree;
+  appendSumOfProducts (*tree, cubes, inputs, [&] (size_t i) {
+    Parser::Algebra variable;
+    variable.type = Parser::AlgebraType::VARIABLE;
+    variable.variable = arguments[i];
+    return tree->push (variable);
+  });
+  return tree;
+}
+
+//! \brief Inputs of the largest loaded table a call may inline
+constexpr uint32_t maxInlinedInputs = 16;
+
+//! \brief Inline the definitions a bound tree calls
+//! \details Each call is replaced by a copy of the pool of its definition,
+//!          whose argument leaves point at the nodes of the call arguments.
+//!          An argument used several times is shared, so nothing is left
+//!          to look up or call when the definition is evaluated. A table
+//!          made by LOAD is inlined as its minimized sum of products.
+//! \param reference inline the unsimplified trees kept for --verify
+//! \return false if a call names no definition or has the wrong arity
+static bool
+expandCalls (Parser::SynTree &tree, Symbols::Symbol caller,
+             bool reference = false)
+{
+  using Parser::AlgebraType;
+  using Parser::NodeIndex;
+  using Parser::OperationType;
+  using Parser::SynNode;
+
+  auto isCall = [] (const SynNode &node) {
+    return node.val.type == AlgebraType::CALL;
+  };
+  if (std::none_of (tree.nodes.begin (), tree.nodes.end (), isCall))
+    return true;
+
+  Parser::SynTree expanded;
+  std::vector<SynNode> &nodes = expanded.nodes;
+  std::vector<NodeIndex> moved (tree.nodes.size (), Parser::NO_NODE);
+
+  // Copy a node, its children already moved by map
+  auto copy = [&] (SynNode node, const std::vector<NodeIndex> &map) {
+    if (node.val.type == AlgebraType::OPERATION)
+      {
+        node.right = map[node.right];
+        if (node.val.operation != OperationType::NOT)
+          node.left = map[node.left];
+      }
+    nodes.push_back (node);
+    return NodeIndex (nodes.size () - 1);
+  };
+
+  for (size_t i = 0; i < tree.nodes.size (); ++i)
     {
-      expression += "(" + minterms[i] + ")";
-      if (i < minterms.size () - 1)
+      const SynNode &node = tree.nodes[i];
+      if (node.val.type == AlgebraType::ARGUMENT) continue;
+      if (!isCall (node))
+        {
+          moved[i] = copy (node, moved);
+          continue;
+        }
+
+      std::vector<NodeIndex> arguments;
+      for (NodeIndex a = node.right; a != Parser::NO_NODE;
+           a = tree.nodes[a].right)
+        arguments.push_back (moved[tree.nodes[a].left]);
+
+      const Func *callee = nullptr;
+      for (const auto &func : programNameSpace)
+        if (func.name == node.val.variable)
+          {
+            callee = &func;
+            break;
+          }
+      if (callee == nullptr)
+        {
+          std::cerr << "EVALUATION ERROR: function "
+                    << Symbols::name (node.val.variable)
+                    << " undefined, called by " << Symbols::name (caller)
+                    << '\n';
+          return false;
+        }
+      if (callee->argNames.size () != arguments.size ())
+        {
+          std::cerr << "SYNTAX ERROR: " << Symbols::name (callee->name)
+                    << " takes " << callee->argNames.size ()
+                    << " arguments, called with " << arguments.size ()
+                    << " by " << Symbols::name (caller) << '\n';
+          return false;
+        }
+
+      // A loaded table has no pool, its minimized sum of products is used
+      if (callee->nodes.empty ())
+        {
+          if (callee->table == nullptr
+              || callee->table->inputs > maxInlinedInputs)
+            {
+              std::cerr << "EVALUATION ERROR: " << Symbols::name (caller)
+                        << " can not call " << Symbols::name (callee->name)
+                        << ", only loaded tables of at most "
+                        << maxInlinedInputs << " inputs can be inlined\n";
+              return false;
+            }
+          moved[i] = appendSumOfProducts (
+              expanded,
+              Minimize::minimize (onSet (*callee->table),
+                                  callee->table->inputs),
+              callee->table->inputs,
+              [&] (size_t input) { return arguments[input]; });
+          continue;
+        }
+
+      // Argument leaves become the argument nodes, the rest is copied
+      Parser::NodeSpan pool = reference && callee->reference != nullptr
+                                  ? Parser::NodeSpan (callee->reference->nodes)
+                                  : callee->nodes;
+      std::vector<NodeIndex> inlined (pool.size ());
+      for (size_t j = 0; j < pool.size (); ++j)
         {
-          expression += " | ";
+          const SynNode &body = pool[j];
+          if (body.val.type == AlgebraType::VARIABLE)
+            inlined[j] = arguments[body.slot];
+          else
+            inlined[j] = copy (body, inlined);
         }
+      moved[i] = inlined.back ();
     }
 
-  return std::make_pair (expression, variables);
+  // A call may return one of its arguments, repeat it so the root is last
+  if (moved.back () != nodes.size () - 1)
+    {
+      SynNode root = nodes[moved.back ()];
+      nodes.push_back (root);
+    }
+  tree.nodes = std::move (nodes);
+  return true;
 }
+
 } // end namespace
 
 /*----------------------------------------------------------------------/
  *------------------------------MODULE EXPR-----------------------------/
  *---------------------------------------------------------------------*/
 
+//! \brief Evaluate the RUN commands waiting in the batch
+//! \details A function with a program evaluates the whole batch in one
+//!          bit-sliced runBlock, each RUN being one lane.
+extern void
+flush ()
+{
+  if (pendingRuns.rows.empty ()) return;
+  const Func &func = *pendingRuns.func;
+  std::vector<std::vector<unsigned char> > &rows = pendingRuns.rows;
+
+  if (func.program == nullptr)
+    {
+      for (const auto &values : rows)
+        {
+          std::optional<unsigned char> answer = evaluate (func, values);
+          if (answer.has_value ())
+            std::cout << "EVALUATION RUN: "
+                      << static_cast<int> (answer.value ()) << '\n';
+        }
+    }
+  else
+    {
+      uint32_t words = blockWords (func);
+      std::vector<uint64_t> inputs (func.argNames.size () * words, 0);
+      std::vector<uint64_t> results (words);
+      for (size_t lane = 0; lane < rows.size (); ++lane)
+        for (size_t slot = 0; slot < func.argNames.size (); ++slot)
+          inputs[slot * words + lane / Vm::sliceLanes]
+              |= uint64_t (rows[lane][slot] & 1) << (lane % Vm::sliceLanes);
+      runBlock (func, inputs.data (), results.data ());
+
+      for (size_t lane = 0; lane < rows.size (); ++lane)
+        {
+          unsigned char result
+              = (results[lane / Vm::sliceLanes] >> (lane % Vm::sliceLanes))
+                & 1;
+          std::cout << "EVALUATION RUN: " << static_cast<int> (result) << '\n';
+          if (programOptions.verify) verify (func, rows[lane], result);
+        }
+    }
+
+  rows.clear ();
+  pendingRuns.func = nullptr;
+}
+
+//! \brief Add a function to the program namespace, compiled as configured
+extern void
+define (Func func)
+{
+  if (programOptions.aig)
+    {
+      Aig::Graph *lowered = Aig::lower (func.nodes, func.argNames.size ());
+      if (lowered != nullptr)
+        {
+          func.aig = Aig::rewrite (*lowered);
+          if (programOptions.stats)
+            std::cerr << "INFO: AIG " << Symbols::name (func.name) << ": "
+                      << func.nodes.size () << " tree nodes, "
+                      << lowered->andCount () << " AND nodes, "
+                      << func.aig->andCount () << " after rewriting\n";
+          delete lowered;
+        }
+    }
+
+  // Definitions from an image may already carry their program
+  if (func.aig != nullptr)
+    {
+      delete func.program;
+      func.program = Vm::compile (*func.aig);
+    }
+  else if (func.program == nullptr)
+    {
+      func.program = Vm::compile (func.nodes, func.argNames.size ());
+    }
+  if (programOptions.stats && func.program != nullptr)
+    std::cerr << "INFO: VM " << Symbols::name (func.name) << ": "
+              << func.program->code.size () << " instructions, stack "
+              << func.program->maxStack << ", temporaries "
+              << func.program->temps << '\n';
+
+  if (programOptions.jit && func.program != nullptr)
+    {
+      func.jit = Jit::compile (*func.program);
+      if (programOptions.stats && func.jit != nullptr)
+        std::cerr << "INFO: JIT " << Symbols::name (func.name) << ": "
+                  << func.jit->length << " bytes of machine code\n";
+    }
+
+  if (programOptions.table && func.program != nullptr)
+    {
+      func.table = Vm::tabulate (*func.program);
+      if (programOptions.stats && func.table != nullptr)
+        std::cerr << "INFO: TABLE " << Symbols::name (func.name) << ": "
+                  << func.table->bits.size () * sizeof (uint64_t)
+                  << " bytes\n";
+    }
+
+  if (programOptions.incremental)
+    {
+      func.cones = Vm::cones (func.nodes, func.argNames.size ());
+      if (programOptions.stats && func.cones != nullptr)
+        std::cerr << "INFO: CONES " << Symbols::name (func.name) << ": "
+                  << func.cones->nodes.size () << " nodes in the cones of "
+                  << func.argNames.size () << " inputs, "
+                  << func.nodes.size () << " nodes in the definition\n";
+    }
+
+  if (programOptions.bdd)
+    {
+      Bdd::Stats before = Bdd::stats ();
+      func.bdd = Bdd::build (func.nodes);
+      if (programOptions.stats && func.bdd != Bdd::NONE)
+        {
+          const Bdd::Stats &after = Bdd::stats ();
+          std::cerr << "INFO: BDD " << Symbols::name (func.name) << ": "
+                    << Bdd::nodeCount (func.bdd) << " nodes, "
+                    << Bdd::satCount (func.bdd, func.argNames.size ())
+                    << " satisfying assignments, cache "
+                    << after.cacheHits - before.cacheHits << '/'
+                    << after.cacheLookups - before.cacheLookups
+                    << " hits, " << after.liveNodes << " live nodes";
+          // Equal functions over as many arguments share their root
+          for (const auto &i : programNameSpace)
+            if (i.bdd == func.bdd
+                && i.argNames.size () == func.argNames.size ())
+              {
+                std::cerr << ", same function as " << Symbols::name (i.name);
+                break;
+              }
+          std::cerr << '\n';
+        }
+    }
+  programNameSpace.push_back (func);
+}
+
 //! \brief Function that interprets parser commands
 extern void
 interpret (Parser::Command command)
@@ -200,102 +1189,179 @@ interpret (Parser::Command command)
   using Parser::Command;
   using Parser::CommandType;
 
+  // Any other command may print or change the namespace
+  if (command.type != CommandType::RUN) flush ();
+
   switch (command.type)
     {
     case CommandType::DEFINE:
       {
         Func def{ command.name, command.arguments,
                                 command.definition };
-        programNameSpace.push_back (def);
+        if (Parser::bindArguments (*def.definition, def.argNames) > 0)
+          {
+            reportUnbound (*def.definition, def.name);
+            delete def.definition;
+            return;
+          }
+        if (programOptions.verify)
+          def.reference = new Parser::SynTree (*def.definition);
+        if (!expandCalls (*def.definition, def.name)
+            || (def.reference != nullptr
+                && !expandCalls (*def.reference, def.name, true)))
+          {
+            delete def.definition;
+            delete def.reference;
+            return;
+          }
+
+        size_t parsedNodes = def.definition->nodes.size ();
+        Simplify::simplify (*def.definition);
+        if (programOptions.stats)
+          std::cerr << "INFO: SIMPLIFY " << Symbols::name (def.name) << ": "
+                    << parsedNodes << " tree nodes, "
+                    << def.definition->nodes.size ()
+                    << " after simplification\n";
+        def.nodes = def.definition->nodes;
+        define (def);
         return;
       } // END DEFINE
 
     case CommandType::RUN:
       {
-        std::vector<std::string> arguments;
-        std::string name = command.name;
-        std::vector<unsigned char> values = command.values;
-        Parser::SynTree *definition;
+        Symbols::Symbol name = command.name;
+        const std::vector<unsigned char> &values = command.values;
+        const Func *func = nullptr;
 
         if (programNameSpace.size () == 0)
           {
             std::cout << "RUNTIME ERROR: could not find definition for "
-                      << name << " in scope\n";
+                      << Symbols::name (name) << " in scope\n";
             return;
           }
 
-        for (auto i : programNameSpace)
+        for (const auto &i : programNameSpace)
           if (i.name == name)
             {
-              definition = i.definition;
-              arguments = i.argNames;
+              func = &i;
               break;
             }
 
-        if (arguments.size () != values.size ())
+        if (func != pendingRuns.func
+            || (func != nullptr
+                && pendingRuns.rows.size ()
+                       == blockWords (*func) * Vm::sliceLanes))
+          flush ();
+
+        if (func != nullptr && !command.fileName.empty ())
           {
-            std::cerr << "SYNTAX ERROR: incomplete RUN command definition\n";
+            flush ();
+            evaluateFile (*func, command.fileName);
             return;
           }
 
-        if (definition == nullptr)
+        if ((func ? func->argNames.size () : 0) != values.size ())
           {
-            std::cerr << "EVALUATION ERROR: function " << name
-                      << " undefined\n";
+            std::cerr << "SYNTAX ERROR: incomplete RUN command definition\n";
             return;
           }
 
-        std::optional<unsigned char> answer
-            = evaluateSynTree (definition, arguments, values);
+        if (func == nullptr)
+          {
+            std::cerr << "EVALUATION ERROR: function "
+                      << Symbols::name (name) << " undefined\n";
+            return;
+          }
 
-        if (answer.has_value ())
-          std::cout << "EVALUATION RUN: " << static_cast<int> (answer.value ())
-                    << '\n';
+        if (hasLookup (*func))
+          {
+            std::optional<unsigned char> answer = evaluate (*func, values);
+            std::cout << "EVALUATION RUN: "
+                      << static_cast<int> (answer.value ()) << '\n';
+            return;
+          }
 
+        // Evaluated together with the following RUN commands of func
+        pendingRuns.func = func;
+        pendingRuns.rows.push_back (values);
         return;
       }
 
     case CommandType::CLEAR:
       {
-        programNameSpace.clear ();
-        programNameSpace.resize (0);
-        for (auto i : programNameSpace)
+        // Each definition owns its node pool, release them all
+        for (auto &i : programNameSpace)
           {
-            if (i.definition != nullptr) i.definition->destroy ();
+            delete i.definition;
+            delete i.aig;
+            delete i.program;
+            delete i.jit;
+            delete i.table;
+            delete i.cones;
+            delete i.reference;
+            Bdd::release (i.bdd);
+            i.definition = nullptr;
+            i.aig = nullptr;
+            i.program = nullptr;
+            i.jit = nullptr;
+            i.table = nullptr;
+            i.cones = nullptr;
+            i.bdd = Bdd::NONE;
           }
+        programNameSpace.clear ();
         return;
       }
 
     case CommandType::ALL:
       {
-        std::string name = command.name;
-        std::vector<std::string> arguments;
-        Parser::SynTree *definition;
+        Symbols::Symbol name = command.name;
+        const Func *func = nullptr;
 
         if (programNameSpace.size () == 0)
           {
             std::cout << "RUNTIME ERROR: could not find definition for "
-                      << name << " in scope\n";
+                      << Symbols::name (name) << " in scope\n";
             return;
           }
-        for (auto i : programNameSpace)
+        for (const auto &i : programNameSpace)
           {
             if (i.name == name)
               {
-                arguments = i.argNames;
-                definition = i.definition;
+                func = &i;
                 break;
               }
           }
 
-        if (arguments.size () == 0)
+        if (func == nullptr || func->argNames.size () == 0)
           {
-            std::cerr << "EVALUATION ERROR: function " << name
-                      << " undefined\n";
+            std::cerr << "EVALUATION ERROR: function "
+                      << Symbols::name (name) << " undefined\n";
             return;
           }
 
-        evaluateAndPrintAll (name, arguments, definition);
+        if (command.mode != Parser::AllMode::ROWS
+            && ((func->program == nullptr && func->table == nullptr)
+                || func->argNames.size () >= 64))
+          std::cerr << "EVALUATION ERROR: rows of " << Symbols::name (name)
+                    << (command.mode == Parser::AllMode::COUNT
+                            ? " can not be counted\n"
+                            : " can not be searched for the first ones\n");
+        else if (command.mode == Parser::AllMode::COUNT)
+          countAll (*func);
+        else if (command.mode == Parser::AllMode::FIRST)
+          printFirst (*func, command.limit);
+        else if (command.fileName.empty ())
+          evaluateAndPrintAll (*func);
+        else
+          saveAll (*func, command.fileName);
+        return;
+      }
+
+    case CommandType::LOAD:
+      {
+        Func func{ command.name, {}, nullptr };
+        func.table = Packed::load (command.fileName.c_str (), func.argNames);
+        if (func.table != nullptr) programNameSpace.push_back (func);
         return;
       }
 
@@ -316,49 +1382,40 @@ interpret (Parser::Command command)
               functionName += alphabet[rand () % alphabetSize];
             }
         }
-        auto boolExpr = getBooleanExpression (command.table);
-        std::string rawDef = "DEFINE " + functionName + "(";
-        for (size_t i = 0; i < boolExpr.second.size () - 1; ++i)
+        if (command.table.N > 64)
           {
-            rawDef += boolExpr.second[i] + ", ";
+            std::cerr << "EVALUATION ERROR: FIND takes at most 64 inputs, "
+                      << command.table.N << " given\n";
+            return;
           }
-        rawDef += boolExpr.second[boolExpr.second.size () - 1];
-        rawDef += "): ";
-        rawDef += "\"" + boolExpr.first + "\"\n";
-        std::string filename = "." + functionName + ".txt";
-
-        { // save definition
-          FILE *outFile = fopen (filename.c_str (), "w");
-          if (outFile)
-            {
-              fprintf (outFile, "%s", rawDef.c_str ());
-              fclose (outFile);
-            }
-          else
-            {
-              std::cerr << "Unable to open file";
-            }
-        }
 
-        { // read file with command
-          FILE *infile;
-          infile = fopen (filename.c_str (), "r");
-          if (infile == NULL)
-            {
-              std::cerr << "ERROR: Could not open file\n";
-              exit (1);
-            }
-          else
-            {
-              std::cout << "INFO: File successfully loaded\n";
-            }
+        // Build the definition straight from the table, no text involved
+        std::vector<Symbols::Symbol> arguments;
+        for (size_t i = 0; i < command.table.N; ++i)
+          arguments.push_back (Symbols::intern (inputName (i)));
+        std::vector<Minimize::Cube> rows = onSet (command.table);
+        bool minimal = false;
+        std::vector<Minimize::Cube> cubes
+            = Minimize::minimize (rows, command.table.N, &minimal);
+        Minimize::Cost before = Minimize::cost (rows);
+        Minimize::Cost after = Minimize::cost (cubes);
+        std::cerr << "INFO: FIND " << functionName << ": " << before.terms
+                  << " terms, " << before.literals << " literals minimized "
+                  << (minimal ? "exactly"
+                      : command.table.N <= Minimize::exactInputs
+                          ? "within the search bound"
+                          : "heuristically")
+                  << " to " << after.terms << " terms, " << after.literals
+                  << " literals\n";
+        interpret (Command{
+            .definition = sumOfProducts (cubes, command.table.N, arguments),
+            .type = CommandType::DEFINE,
+            .arguments = arguments,
+            .name = Symbols::intern (functionName) });
 
-          std::vector<Tokenizer::Token> *tokens = Tokenizer::tokenize (infile);
-          auto command = Parser::parse (0, tokens);
-          interpret (command.second);
-        }
-        std::cout << "EVALUATION FIND: formula found: " << boolExpr.first
-                  << ' ' << " with name: " << functionName << '\n';
+        std::cout << "EVALUATION FIND: formula found: "
+                  << formatSumOfProducts (cubes, command.table.N) << ' '
+                  << " with name: " << functionName << '\n';
       };
     }
 }
@@ -0,0 +1,273 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file jit.cpp
+ * \author Delyan Kirov
+ * \brief Implementation of the x86-64 compiler of bytecode programs
+ * \details The postfix program is replayed at compile time, the stack
+ *          entries live in registers and only deep ones spill to memory,
+ *          so the generated code has no dispatch at all.
+ *---------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+
+#include "jit.hpp"
+#include "vm.hpp"
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__linux__)
+#define JIT_X86_64 1
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace Jit
+{
+namespace
+{
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE TYPES-------------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief x86-64 general purpose register numbers
+enum Register : uint8_t
+{
+  RAX = 0,
+  RCX = 1,
+  RDX = 2,
+  RSI = 6, // scratch argument
+  RDI = 7, // inputs argument
+  R8 = 8,
+  R9 = 9,
+  R10 = 10,
+  R11 = 11, // temporary for memory to memory operations
+};
+
+//! \brief Registers holding the lowest stack entries, the first the result
+constexpr Register stackRegisters[] = { RAX, RCX, RDX, R8, R9, R10 };
+constexpr uint32_t registerCount = std::size (stackRegisters);
+
+//! \brief Opcodes of the instructions used by the code generator
+enum Opcode : uint8_t
+{
+  OR_STORE = 0x09,  // or r/m64, r64
+  OR_LOAD = 0x0B,   // or r64, r/m64
+  AND_STORE = 0x21, // and r/m64, r64
+  AND_LOAD = 0x23,  // and r64, r/m64
+  MOV_STORE = 0x89, // mov r/m64, r64
+  MOV_LOAD = 0x8B,  // mov r64, r/m64
+  MOV_IMM = 0xC7,   // mov r/m64, imm32 sign extended
+  RET = 0xC3,
+  UNARY = 0xF7, // not r/m64 with /2
+};
+
+//! \brief Machine code buffer with the encodings of the used instructions
+struct Assembler
+{
+  std::vector<uint8_t> code;
+
+  void
+  emit32 (uint32_t value)
+  {
+    for (int i = 0; i < 4; ++i)
+      code.push_back (value >> (8 * i));
+  }
+
+  //! \brief op between two registers, reg in the ModRM reg field
+  void
+  registers (Opcode op, uint8_t rm, uint8_t reg, uint8_t digit = 0)
+  {
+    code.push_back (0x48 | (reg >> 3) << 2 | rm >> 3); // REX.W
+    code.push_back (op);
+    code.push_back (0xC0 | ((reg | digit) & 7) << 3 | (rm & 7));
+  }
+
+  //! \brief op between a register and the word at base + 8 * index
+  void
+  memory (Opcode op, uint8_t reg, uint8_t base, uint32_t index)
+  {
+    code.push_back (0x48 | (reg >> 3) << 2 | base >> 3); // REX.W
+    code.push_back (op);
+    code.push_back (0x80 | (reg & 7) << 3 | (base & 7)); // [base + disp32]
+    emit32 (index * 8);
+  }
+};
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE IMPL-----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Largest word index that still fits a 32-bit displacement
+constexpr uint32_t maxIndex = (1u << 28) - 1;
+
+//! \brief Generate the code of a program, stack entry d in a register
+//!        while d < registerCount and in scratch[temps + d] otherwise
+static std::vector<uint8_t>
+generate (const Vm::Program &program)
+{
+  Assembler as;
+  uint32_t spill = program.temps; // Scratch index of stack entry 0
+  uint32_t top = 0;               // Number of entries on the stack
+
+  auto inRegister = [] (uint32_t depth) { return depth < registerCount; };
+
+  // Push the word at base + 8 * index
+  auto push = [&] (uint8_t base, uint32_t index) {
+    if (inRegister (top))
+      {
+        as.memory (MOV_LOAD, stackRegisters[top], base, index);
+      }
+    else
+      {
+        as.memory (MOV_LOAD, R11, base, index);
+        as.memory (MOV_STORE, R11, RSI, spill + top);
+      }
+    ++top;
+  };
+
+  for (Vm::Instruction instruction : program.code)
+    {
+      uint32_t operand = instruction >> Vm::opBits;
+      switch (instruction & Vm::opMask)
+        {
+        case Vm::CONST:
+          {
+            uint8_t reg = inRegister (top) ? stackRegisters[top] : R11;
+            as.registers (MOV_IMM, reg, 0);
+            as.emit32 (operand ? 0xFFFFFFFF : 0);
+            if (!inRegister (top))
+              as.memory (MOV_STORE, R11, RSI, spill + top);
+            ++top;
+            break;
+          }
+        case Vm::LOAD: push (RDI, operand); break;
+        case Vm::TEMP: push (RSI, operand); break;
+        case Vm::STORE:
+          {
+            uint32_t depth = top - 1;
+            if (inRegister (depth))
+              {
+                as.memory (MOV_STORE, stackRegisters[depth], RSI, operand);
+              }
+            else
+              {
+                as.memory (MOV_LOAD, R11, RSI, spill + depth);
+                as.memory (MOV_STORE, R11, RSI, operand);
+              }
+            break;
+          }
+        case Vm::NOT:
+          {
+            uint32_t depth = top - 1;
+            if (inRegister (depth))
+              as.registers (UNARY, stackRegisters[depth], 0, 2);
+            else
+              as.memory (UNARY, 2, RSI, spill + depth);
+            break;
+          }
+        case Vm::AND:
+        case Vm::OR:
+          {
+            bool isAnd = (instruction & Vm::opMask) == Vm::AND;
+            uint32_t left = top - 2, right = top - 1;
+            if (inRegister (right))
+              {
+                as.registers (isAnd ? AND_STORE : OR_STORE,
+                              stackRegisters[left], stackRegisters[right]);
+              }
+            else if (inRegister (left))
+              {
+                as.memory (isAnd ? AND_LOAD : OR_LOAD, stackRegisters[left],
+                           RSI, spill + right);
+              }
+            else
+              {
+                as.memory (MOV_LOAD, R11, RSI, spill + right);
+                as.memory (isAnd ? AND_STORE : OR_STORE, R11, RSI,
+                           spill + left);
+              }
+            --top;
+            break;
+          }
+        }
+    }
+
+  as.code.push_back (RET); // The result is entry 0, in rax
+  return as.code;
+}
+} // end namespace
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE EXPR-----------------------------/
+ *---------------------------------------------------------------------*/
+
+Function::~Function ()
+{
+#ifdef JIT_X86_64
+  if (memory != nullptr) munmap (memory, size);
+#endif
+}
+
+//! \brief Check if machine code can be generated on this platform
+extern bool
+supported ()
+{
+#ifdef JIT_X86_64
+  return true;
+#else
+  return false;
+#endif
+}
+
+//! \brief Compile a program into machine code, nullptr if unsupported
+extern Function *
+compile (const Vm::Program &program)
+{
+#ifdef JIT_X86_64
+  if (program.inputs > maxIndex
+      || uint64_t (program.temps) + program.maxStack > maxIndex)
+    return nullptr;
+
+  std::vector<uint8_t> code = generate (program);
+
+  // Written while writable, then only executable
+  size_t page = sysconf (_SC_PAGESIZE);
+  size_t size = (code.size () + page - 1) / page * page;
+  void *memory = mmap (nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) return nullptr;
+  std::memcpy (memory, code.data (), code.size ());
+  if (mprotect (memory, size, PROT_READ | PROT_EXEC) != 0)
+    {
+      munmap (memory, size);
+      return nullptr;
+    }
+
+  Function *function = new Function;
+  function->entry = reinterpret_cast<Entry> (memory);
+  function->memory = memory;
+  function->size = size;
+  function->length = code.size ();
+  function->scratch = program.temps + program.maxStack;
+  return function;
+#else
+  (void)program;
+  return nullptr;
+#endif
+}
+
+//! \brief Call the code for 64 assignments, one per bit of the inputs
+extern uint64_t
+run (const Function &function, const uint64_t *inputs)
+{
+  static thread_local std::vector<uint64_t> scratch;
+  scratch.resize (function.scratch);
+  return function.entry (inputs, scratch.data ());
+}
+} // end namespace Jit
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
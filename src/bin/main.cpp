@@ -8,67 +8,236 @@
 /*----------------------------------------------------------------------/
  *-----------------------------EXE INCLUDES------------------------------/
  *----------------------------------------------------------------------*/
+#include "image.hpp"
 #include "interpreter.hpp"
+#include "jit.hpp"
 #include "parser.hpp"
+#include "tokenizer.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <utility>
 
 /*----------------------------------------------------------------------/
- *---------------------------------MAIN---------------------------------/
+ *------------------------------EXE IMPL--------------------------------/
  *---------------------------------------------------------------------*/
 
-//! \brief Main function for main.exe
-int
-main (int argc, char *argv[])
+//! \brief Parse and interpret every command of a token stream
+static void
+runCommands (const Tokenizer::TokenStream *tokens)
 {
-  FILE *infile;
-
-  if (argc == 1)
+  try
     {
-      infile = fopen ("/dev/stdin", "r"); // Open stdin for reading
+      size_t idx = 0;
+      for (;;)
+        {
+          auto command = Parser::parse (idx, tokens);
+          idx = command.first;
+          if (command.second.type == Parser::CommandType::EXIT) break;
+          if (command.second.type == Parser::CommandType::TRIVIAL) continue;
+          Interpreter::interpret (command.second);
+        }
+      Interpreter::flush ();
     }
-  else
+  catch (...)
     {
-      char *fileName = argv[1];
-      infile = fopen (fileName, "r");
+      Interpreter::flush ();
+      std::cerr << "PARSER ERROR: incorrect syntax\n";
+      exit (2);
     }
+}
+
+//! \brief Check if a line ends a command unit
+//! \details Only FIND tables continue over lines, each row but the last
+//!          one ending with ';'.
+static bool
+endsUnit (const char *line, size_t length)
+{
+  while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == ' '))
+    --length;
+  return length == 0 || line[length - 1] != ';';
+}
 
-  if (infile == nullptr)
+//! \brief Tokenize, parse and interpret one command unit at a time
+//! \details Memory is bounded by the longest unit, and the output of a
+//!          unit is flushed before the next one is read.
+static void
+streamCommands (FILE *infile)
+{
+  std::string unit;
+  char *line = nullptr;
+  size_t capacity = 0;
+  ssize_t length;
+
+  while ((length = getline (&line, &capacity, infile)) != -1)
     {
-      std::cerr << "ERROR: Could not open file\n";
-      return 1;
+      unit.append (line, length);
+      if (!endsUnit (line, length)) continue;
+
+      Tokenizer::TokenStream tokens
+          = Tokenizer::tokenize (unit.data (), unit.size ());
+      runCommands (&tokens);
+      std::cout.flush ();
+      unit.clear ();
     }
 
-  std::vector<Tokenizer::Token> *tokens;
-  try
+  if (!unit.empty ()) // Unterminated unit at end of input
     {
-      tokens = Tokenizer::tokenize (infile);
+      Tokenizer::TokenStream tokens
+          = Tokenizer::tokenize (unit.data (), unit.size ());
+      runCommands (&tokens);
     }
-  catch (...)
+  free (line);
+}
+
+//! \brief Most threads -j may ask for
+constexpr unsigned long maxThreads = 256;
+
+//! \brief Print the command line usage and return the exit code
+static int
+usage (const char *program)
+{
+  std::cerr << "USAGE: " << program
+            << " [-j threads] [--aig] [--stats] [--verify] [--jit]"
+               " [--truth-table] [--bdd] [--incremental]"
+               " [--load-image image] [--save-image image] [file]\n";
+  return 1;
+}
+
+//! \brief Threads of a -j value, 0 for every core
+//! \return 0 if the value is not a number from 0 to maxThreads
+static unsigned
+parseThreads (const char *value)
+{
+  char *end = nullptr;
+  errno = 0;
+  unsigned long threads = strtoul (value, &end, 10);
+  if (value[0] < '0' || value[0] > '9' || *end != '\0' || errno != 0
+      || threads > maxThreads)
+    return 0;
+  if (threads == 0)
+    threads = std::clamp<unsigned long> (std::thread::hardware_concurrency (),
+                                         1, maxThreads);
+  return threads;
+}
+
+//! \brief Write the namespace image if requested and return the exit code
+static int
+finish (const char *saveImage)
+{
+  if (saveImage != nullptr && !Image::save (saveImage)) return 1;
+  return 0;
+}
+
+/*----------------------------------------------------------------------/
+ *---------------------------------MAIN---------------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Main function for main.exe
+int
+main (int argc, char *argv[])
+{
+  const char *fileName = nullptr;
+  const char *loadImage = nullptr;
+  const char *saveImage = nullptr;
+  unsigned threads = 1;
+
+  for (int i = 1; i < argc; ++i)
     {
-      std::cerr << "TOKENIZER ERROR: incorrect syntax\n";
-      exit (2);
+      std::string_view arg = argv[i];
+      if (arg == "-j" && i + 1 < argc)
+        {
+          threads = parseThreads (argv[++i]);
+          if (threads == 0)
+            {
+              std::cerr << "ERROR: -j takes 0 for every core or 1 to "
+                        << maxThreads << " threads, not " << argv[i] << '\n';
+              return usage (argv[0]);
+            }
+          programOptions.threads = threads;
+        }
+      else if (arg == "--aig")
+        {
+          programOptions.aig = true;
+        }
+      else if (arg == "--stats")
+        {
+          programOptions.stats = true;
+        }
+      else if (arg == "--verify")
+        {
+          programOptions.verify = true;
+        }
+      else if (arg == "--jit")
+        {
+          programOptions.jit = Jit::supported ();
+          if (!programOptions.jit)
+            std::cerr << "INFO: JIT not supported on this platform, "
+                         "using the bytecode interpreter\n";
+        }
+      else if (arg == "--truth-table")
+        {
+          programOptions.table = true;
+        }
+      else if (arg == "--bdd")
+        {
+          programOptions.bdd = true;
+        }
+      else if (arg == "--incremental")
+        {
+          programOptions.incremental = true;
+        }
+      else if (arg == "--load-image" && i + 1 < argc)
+        {
+          loadImage = argv[++i];
+        }
+      else if (arg == "--save-image" && i + 1 < argc)
+        {
+          saveImage = argv[++i];
+        }
+      else if (arg.size () > 1 && arg[0] == '-')
+        {
+          return usage (argv[0]);
+        }
+      else
+        {
+          fileName = argv[i];
+        }
     }
 
-  try
+  if (loadImage != nullptr && !Image::load (loadImage)) return 1;
+
+  if (fileName == nullptr)
     {
-      auto command = Parser::parse (0, tokens);
-      Interpreter::interpret (command.second);
+      streamCommands (stdin);
+      return finish (saveImage);
+    }
 
-      for (;;)
+  // Regular files are mapped, anything else (pipes, fifos) is streamed
+  Tokenizer::MappedFile *mapped = Tokenizer::mapFile (fileName);
+  if (mapped == nullptr)
+    {
+      FILE *infile = fopen (fileName, "r");
+      if (infile == nullptr)
         {
-          command = Parser::parse (command.first, tokens);
-          if (command.second.type == Parser::CommandType::TRIVIAL) continue;
-          Interpreter::interpret (command.second);
+          std::cerr << "ERROR: Could not open file\n";
+          return 1;
         }
+      streamCommands (infile);
+      fclose (infile);
+      return finish (saveImage);
     }
-  catch (...)
-    {
-      std::cerr << "PARSER ERROR: incorrect syntax\n";
-      exit (2);
-    }
-  return 0;
+
+  Tokenizer::TokenStream tokens
+      = Tokenizer::tokenizeParallel (mapped->data, mapped->size, threads);
+  runCommands (&tokens);
+  delete mapped;
+  return finish (saveImage);
 }
 
 /*----------------------------------------------------------------------/
@@ -0,0 +1,430 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file minimize.cpp
+ * \author Delyan Kirov
+ * \brief Implementation of the two-level minimization of sums of products
+ * \details The function is given by its on set alone, every other row is
+ *          0, so a cube is an implicant exactly when all of its minterms
+ *          are in the on set. Both methods keep the on set in a table
+ *          and check cubes minterm by minterm, which costs no more than
+ *          the rows the table was built from.
+ *---------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+
+#include "minimize.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Minimize
+{
+namespace
+{
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE DEFINES-----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Nodes the exact cover search may visit, the best cover found
+//!        so far is kept when it runs out
+constexpr size_t searchNodes = 1 << 18;
+
+//! \brief Weight of a term against one literal
+//! \details A cover takes at most one term per on set minterm, so its
+//!          literals never reach exactInputs * 2^exactInputs and one term
+//!          more always weighs more than any literals saved.
+constexpr size_t termWeight = exactInputs * (size_t (1) << exactInputs) + 1;
+
+//! \brief Reduce, expand and irredundant rounds of the heuristic
+constexpr size_t maxPasses = 16;
+
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE TYPES-------------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Indices of on set minterms, at most exactInputs inputs
+using MintermSet = std::array<uint64_t, (size_t (1) << exactInputs) / 64>;
+
+//! \brief Cubes of the current cover holding each on set minterm
+using Counts = std::unordered_map<uint64_t, uint32_t>;
+
+//! \brief State of the exact cover search
+struct Search
+{
+  std::vector<MintermSet> covers;               // Minterms of each prime
+  std::vector<std::vector<uint32_t> > choices;  // Primes of each minterm
+  std::vector<size_t> weights;                  // Weight of each prime
+  std::vector<uint32_t> chosen{};
+  std::vector<uint32_t> best{};
+  size_t bestWeight = SIZE_MAX;
+  size_t nodes = 0;
+  bool bounded = false; // The search ran out of nodes
+};
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE IMPL-----------------------------/
+ *---------------------------------------------------------------------*/
+
+static inline uint64_t
+fullMask (uint32_t inputs)
+{
+  return inputs >= 64 ? ~uint64_t (0) : (uint64_t (1) << inputs) - 1;
+}
+
+static inline size_t
+literals (const Cube &cube)
+{
+  return std::popcount (cube.care);
+}
+
+static inline bool
+before (const Cube &a, const Cube &b)
+{
+  return a.care != b.care ? a.care < b.care : a.value < b.value;
+}
+
+static inline bool
+cheaper (const Cost &a, const Cost &b)
+{
+  return a.terms != b.terms ? a.terms < b.terms : a.literals < b.literals;
+}
+
+//! \brief Call visit on every minterm of a cube until it returns false
+//! \return false if visit stopped the walk
+template <typename Visit>
+static bool
+forEachMinterm (const Cube &cube, uint64_t full, Visit visit)
+{
+  uint64_t free = full & ~cube.care;
+  uint64_t rest = 0;
+  do
+    {
+      if (!visit (cube.value | rest)) return false;
+      rest = (rest - free) & free;
+    }
+  while (rest != 0);
+  return true;
+}
+
+//! \brief Every prime implicant, merging cubes that differ in one input
+static std::vector<Cube>
+primes (std::vector<Cube> level)
+{
+  std::vector<Cube> found;
+  while (!level.empty ())
+    {
+      std::sort (level.begin (), level.end (), before);
+      level.erase (std::unique (level.begin (), level.end (),
+                                [] (const Cube &a, const Cube &b) {
+                                  return a.care == b.care
+                                         && a.value == b.value;
+                                }),
+                   level.end ());
+
+      std::vector<bool> merged (level.size (), false);
+      std::vector<Cube> next;
+      for (size_t i = 0; i < level.size (); ++i)
+        for (uint64_t rest = level[i].care & ~level[i].value; rest != 0;
+             rest &= rest - 1)
+          {
+            uint64_t bit = rest & -rest;
+            Cube partner{ level[i].care, level[i].value | bit };
+            auto at = std::lower_bound (level.begin (), level.end (),
+                                        partner, before);
+            if (at == level.end () || before (partner, *at)) continue;
+            merged[i] = merged[at - level.begin ()] = true;
+            next.push_back ({ level[i].care & ~bit, level[i].value });
+          }
+
+      for (size_t i = 0; i < level.size (); ++i)
+        if (!merged[i]) found.push_back (level[i]);
+      level = std::move (next);
+    }
+  return found;
+}
+
+//! \brief Branch on the uncovered minterm with the fewest primes
+static void
+search (Search &state, const MintermSet &uncovered, size_t weight)
+{
+  if (state.nodes++ >= searchNodes && !state.best.empty ())
+    {
+      state.bounded = true;
+      return;
+    }
+
+  size_t first = SIZE_MAX;
+  for (size_t word = 0; word < uncovered.size (); ++word)
+    for (uint64_t rest = uncovered[word]; rest != 0; rest &= rest - 1)
+      {
+        size_t minterm = word * 64 + std::countr_zero (rest);
+        if (first == SIZE_MAX
+            || state.choices[minterm].size () < state.choices[first].size ())
+          first = minterm;
+      }
+  if (first == SIZE_MAX)
+    {
+      if (weight < state.bestWeight)
+        {
+          state.bestWeight = weight;
+          state.best = state.chosen;
+        }
+      return;
+    }
+
+  for (uint32_t prime : state.choices[first])
+    {
+      size_t next = weight + state.weights[prime];
+      if (next >= state.bestWeight) continue;
+      MintermSet rest;
+      for (size_t word = 0; word < rest.size (); ++word)
+        rest[word] = uncovered[word] & ~state.covers[prime][word];
+      state.chosen.push_back (prime);
+      search (state, rest, next);
+      state.chosen.pop_back ();
+    }
+}
+
+//! \brief Quine-McCluskey primes and a branch and bound cover
+static std::vector<Cube>
+exact (const std::vector<Cube> &minterms, uint32_t inputs, bool &bounded)
+{
+  uint64_t full = fullMask (inputs);
+  std::vector<Cube> found = primes (minterms);
+
+  std::vector<uint32_t> index (size_t (1) << inputs, 0);
+  for (size_t i = 0; i < minterms.size (); ++i)
+    index[minterms[i].value] = i;
+
+  Search state{ std::vector<MintermSet> (found.size (), MintermSet{}),
+                std::vector<std::vector<uint32_t> > (minterms.size ()),
+                std::vector<size_t> (found.size ()) };
+  for (size_t prime = 0; prime < found.size (); ++prime)
+    {
+      state.weights[prime] = termWeight + literals (found[prime]);
+      forEachMinterm (found[prime], full, [&] (uint64_t minterm) {
+        uint32_t at = index[minterm];
+        state.covers[prime][at / 64] |= uint64_t (1) << (at % 64);
+        state.choices[at].push_back (prime);
+        return true;
+      });
+    }
+  // Larger primes first, so the first cover found is already a good bound
+  for (std::vector<uint32_t> &choice : state.choices)
+    std::stable_sort (choice.begin (), choice.end (),
+                      [&] (uint32_t a, uint32_t b) {
+                        return state.weights[a] < state.weights[b];
+                      });
+
+  MintermSet uncovered{};
+  for (size_t i = 0; i < minterms.size (); ++i)
+    uncovered[i / 64] |= uint64_t (1) << (i % 64);
+  search (state, uncovered, 0);
+  bounded = state.bounded;
+
+  std::vector<Cube> cover;
+  for (uint32_t prime : state.best)
+    cover.push_back (found[prime]);
+  return cover;
+}
+
+//! \brief Add delta to the count of every minterm of a cube
+static void
+count (const Cube &cube, uint64_t full, Counts &counts, int delta)
+{
+  forEachMinterm (cube, full, [&] (uint64_t minterm) {
+    counts[minterm] += delta;
+    return true;
+  });
+}
+
+//! \brief Grow each cube into a prime, dropping cubes already covered
+//! \details The counts are rebuilt for the expanded cover.
+static void
+expand (std::vector<Cube> &cubes, uint64_t full, Counts &counts)
+{
+  // Raising an input where many cubes hold the opposite literal first
+  // lets the grown cube take in more of them
+  std::array<size_t, 64> ones{}, zeros{};
+  for (const Cube &cube : cubes)
+    for (uint64_t rest = cube.care; rest != 0; rest &= rest - 1)
+      {
+        int input = std::countr_zero (rest);
+        ++((cube.value >> input) & 1 ? ones : zeros)[input];
+      }
+
+  std::stable_sort (cubes.begin (), cubes.end (),
+                    [] (const Cube &a, const Cube &b) {
+                      return literals (a) < literals (b);
+                    });
+  for (auto &entry : counts)
+    entry.second = 0;
+
+  std::vector<Cube> expanded;
+  std::vector<int> order;
+  for (Cube cube : cubes)
+    {
+      if (forEachMinterm (cube, full, [&] (uint64_t minterm) {
+            return counts[minterm] != 0;
+          }))
+        continue;
+
+      order.clear ();
+      for (uint64_t rest = cube.care; rest != 0; rest &= rest - 1)
+        order.push_back (std::countr_zero (rest));
+      auto opposite = [&] (int input) {
+        return (cube.value >> input) & 1 ? zeros[input] : ones[input];
+      };
+      std::stable_sort (order.begin (), order.end (), [&] (int a, int b) {
+        return opposite (a) > opposite (b);
+      });
+
+      for (int input : order)
+        {
+          uint64_t bit = uint64_t (1) << input;
+          Cube half{ cube.care, cube.value ^ bit };
+          if (forEachMinterm (half, full, [&] (uint64_t minterm) {
+                return counts.find (minterm) != counts.end ();
+              }))
+            {
+              cube.care &= ~bit;
+              cube.value &= ~bit;
+            }
+        }
+      count (cube, full, counts, 1);
+      expanded.push_back (cube);
+    }
+  cubes = std::move (expanded);
+}
+
+//! \brief Drop cubes whose minterms other cubes all hold, smallest first
+static void
+irredundant (std::vector<Cube> &cubes, uint64_t full, Counts &counts)
+{
+  std::stable_sort (cubes.begin (), cubes.end (),
+                    [] (const Cube &a, const Cube &b) {
+                      return literals (a) > literals (b);
+                    });
+  std::vector<Cube> kept;
+  for (const Cube &cube : cubes)
+    {
+      if (forEachMinterm (cube, full, [&] (uint64_t minterm) {
+            return counts[minterm] >= 2;
+          }))
+        count (cube, full, counts, -1);
+      else
+        kept.push_back (cube);
+    }
+  cubes = std::move (kept);
+}
+
+//! \brief Shrink each cube to the smallest one holding the minterms no
+//!        other cube holds, so the next expand may grow it another way
+static void
+reduce (std::vector<Cube> &cubes, uint64_t full, Counts &counts)
+{
+  std::vector<Cube> reduced;
+  for (const Cube &cube : cubes)
+    {
+      uint64_t all = full;
+      uint64_t any = 0;
+      bool own = false;
+      forEachMinterm (cube, full, [&] (uint64_t minterm) {
+        if (counts[minterm] == 1)
+          {
+            own = true;
+            all &= minterm;
+            any |= minterm;
+          }
+        return true;
+      });
+      count (cube, full, counts, -1);
+      if (!own) continue;
+
+      Cube smaller{ full & ~(all ^ any), all & ~(all ^ any) };
+      count (smaller, full, counts, 1);
+      reduced.push_back (smaller);
+    }
+  cubes = std::move (reduced);
+}
+
+//! \brief Espresso style expand, irredundant and reduce rounds
+static std::vector<Cube>
+heuristic (const std::vector<Cube> &minterms, uint32_t inputs)
+{
+  uint64_t full = fullMask (inputs);
+  Counts counts;
+  counts.reserve (minterms.size ());
+  for (const Cube &minterm : minterms)
+    counts.emplace (minterm.value, 0);
+
+  std::vector<Cube> cubes = minterms;
+  expand (cubes, full, counts);
+  irredundant (cubes, full, counts);
+  std::vector<Cube> best = cubes;
+  for (size_t pass = 0; pass < maxPasses; ++pass)
+    {
+      reduce (cubes, full, counts);
+      expand (cubes, full, counts);
+      irredundant (cubes, full, counts);
+      if (!cheaper (cost (cubes), cost (best))) break;
+      best = cubes;
+    }
+  return best;
+}
+} // end namespace
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE EXPR-----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Terms and literals of a sum of products
+extern Cost
+cost (const std::vector<Cube> &cubes)
+{
+  Cost total{ cubes.size (), 0 };
+  for (const Cube &cube : cubes)
+    total.literals += literals (cube);
+  return total;
+}
+
+//! \brief Sum of products of the same function as the minterms of onSet
+extern std::vector<Cube>
+minimize (const std::vector<Cube> &onSet, uint32_t inputs, bool *minimal)
+{
+  bool bounded = inputs > exactInputs;
+  if (minimal != nullptr) *minimal = true;
+  uint64_t full = fullMask (inputs);
+  std::vector<Cube> minterms;
+  for (const Cube &cube : onSet)
+    minterms.push_back ({ full, cube.value & full });
+  std::sort (minterms.begin (), minterms.end (), before);
+  minterms.erase (std::unique (minterms.begin (), minterms.end (),
+                               [] (const Cube &a, const Cube &b) {
+                                 return a.value == b.value;
+                               }),
+                  minterms.end ());
+  if (minterms.empty ()) return {};
+
+  std::vector<Cube> cubes = inputs <= exactInputs
+                                ? exact (minterms, inputs, bounded)
+                                : heuristic (minterms, inputs);
+  if (minimal != nullptr) *minimal = !bounded;
+  // Larger terms first, then in the order of their rows
+  std::sort (cubes.begin (), cubes.end (),
+             [] (const Cube &a, const Cube &b) {
+               return literals (a) != literals (b)
+                          ? literals (a) < literals (b)
+                          : a.value < b.value;
+             });
+  return cubes;
+}
+} // end namespace Minimize
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
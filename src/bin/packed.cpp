@@ -0,0 +1,175 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file packed.cpp
+ * \author Delyan Kirov
+ * \brief Implementation of bit-packed truth table files
+ *---------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+
+#include "packed.hpp"
+#include "symbols.hpp"
+#include "tokenizer.hpp"
+#include "vm.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+namespace Packed
+{
+namespace
+{
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE DATA-----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Loaded files stay mapped for the lifetime of the process
+std::vector<Tokenizer::MappedFile *> files;
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE IMPL-----------------------------/
+ *---------------------------------------------------------------------*/
+
+static uint64_t
+alignUp (uint64_t offset)
+{
+  return (offset + 63) & ~(uint64_t)63;
+}
+} // end namespace
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE EXPR-----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Write a truth table file chunk by chunk
+extern bool
+save (const char *fileName, const std::vector<Symbols::Symbol> &arguments,
+      const Fill &fill)
+{
+  uint32_t inputs = arguments.size ();
+  if (inputs >= 64)
+    {
+      std::cerr << "ERROR: " << inputs
+                << " arguments are too many to write a truth table\n";
+      return false;
+    }
+
+  std::string names;
+  for (Symbols::Symbol argument : arguments)
+    names += Symbols::name (argument) + '\n';
+
+  Header header{};
+  memcpy (header.magic, packedMagic, sizeof (packedMagic));
+  header.version = packedVersion;
+  header.inputs = inputs;
+  header.namesSize = names.size ();
+  header.bitsOffset = alignUp (sizeof (Header) + names.size ());
+
+  // Written aside and renamed over the target, so a table LOAD mapped
+  // from the old file keeps its inode and stays valid
+  std::string temporary
+      = std::string (fileName) + ".tmp" + std::to_string (getpid ());
+  FILE *file = fopen (temporary.c_str (), "wb");
+  if (file == nullptr)
+    {
+      std::cerr << "ERROR: could not open truth table: " << temporary
+                << '\n';
+      return false;
+    }
+  std::vector<char> start (header.bitsOffset, 0);
+  memcpy (start.data (), &header, sizeof (header));
+  memcpy (start.data () + sizeof (header), names.data (), names.size ());
+  bool written
+      = fwrite (start.data (), 1, start.size (), file) == start.size ();
+
+  uint64_t rows = uint64_t (1) << inputs;
+  std::vector<uint64_t> bits;
+  for (uint64_t first = 0; written && first < rows; first += chunkRows)
+    {
+      uint64_t count = std::min (rows - first, chunkRows);
+      bits.assign ((count + Vm::sliceLanes - 1) / Vm::sliceLanes, 0);
+      fill (first, count, bits.data ());
+      if (count < Vm::sliceLanes) bits[0] &= (uint64_t (1) << count) - 1;
+      written = fwrite (bits.data (), sizeof (uint64_t), bits.size (), file)
+                == bits.size ();
+    }
+  written = fclose (file) == 0 && written;
+  if (written && rename (temporary.c_str (), fileName) != 0)
+    written = false;
+  if (!written)
+    {
+      remove (temporary.c_str ());
+      std::cerr << "ERROR: could not write truth table: " << fileName
+                << '\n';
+    }
+  return written;
+}
+
+//! \brief Map a truth table file, its bits are used in place
+extern Vm::TruthTable *
+load (const char *fileName, std::vector<Symbols::Symbol> &arguments)
+{
+  Tokenizer::MappedFile *mapped = Tokenizer::mapFile (fileName);
+  if (mapped == nullptr)
+    {
+      std::cerr << "ERROR: could not open truth table: " << fileName << '\n';
+      return nullptr;
+    }
+
+  const Header *header = reinterpret_cast<const Header *> (mapped->data);
+  uint64_t words = 0;
+  if (mapped->size >= sizeof (Header) && header->inputs < 64)
+    words = ((uint64_t (1) << header->inputs) + Vm::sliceLanes - 1)
+            / Vm::sliceLanes;
+  if (mapped->size < sizeof (Header)
+      || memcmp (header->magic, packedMagic, sizeof (packedMagic)) != 0
+      || header->version != packedVersion || header->inputs >= 64
+      || header->bitsOffset % 64 != 0
+      || header->bitsOffset > mapped->size
+      || header->namesSize > header->bitsOffset - sizeof (Header)
+      || words > (mapped->size - header->bitsOffset) / sizeof (uint64_t))
+    {
+      std::cerr << "ERROR: " << fileName
+                << " is not a compatible truth table\n";
+      delete mapped;
+      return nullptr;
+    }
+
+  // One newline ended name per argument
+  std::string_view names (mapped->data + sizeof (Header), header->namesSize);
+  arguments.clear ();
+  while (!names.empty ())
+    {
+      size_t end = names.find ('\n');
+      if (end == std::string_view::npos) break;
+      arguments.push_back (Symbols::intern (names.substr (0, end)));
+      names.remove_prefix (end + 1);
+    }
+  if (!names.empty () || arguments.size () != header->inputs)
+    {
+      std::cerr << "ERROR: " << fileName
+                << " holds corrupt argument names\n";
+      delete mapped;
+      return nullptr;
+    }
+
+  Vm::TruthTable *table = new Vm::TruthTable;
+  table->inputs = header->inputs;
+  table->bits = std::span<const uint64_t> (
+      reinterpret_cast<const uint64_t *> (mapped->data + header->bitsOffset),
+      words);
+  files.push_back (mapped);
+  return table;
+}
+} // end namespace Packed
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
@@ -10,8 +10,12 @@
 
 #include "parser.hpp"
 #include "tokenizer.hpp"
+#include <charconv>
 #include <iostream>
+#include <string_view>
+#include <unistd.h>
 #include <utility>
+#include <vector>
 
 namespace Parser
 {
@@ -27,6 +31,16 @@ constexpr const char *fileNameBase = "./src/tst/csvFiles/";
  *------------------------------MODULE IMPL-----------------------------/
  *---------------------------------------------------------------------*/
 
+//! \brief Path of a data file, the working directory first then
+//!        fileNameBase
+static std::string
+dataFilePath (std::string_view name)
+{
+  std::string path (name);
+  if (access (path.c_str (), R_OK) == 0) return path;
+  return fileNameBase + path;
+}
+
 static size_t
 powerOf (size_t a, size_t b)
 {
@@ -56,138 +70,209 @@ tokenToOpType (const TokenType &tokenType)
     }
 }
 
-static void
-printSyntaxTree (const SynTree *node, int depth = 0)
+[[maybe_unused]] static void
+printSyntaxTree (const SynTree &tree, NodeIndex root)
 {
-  if (!node) return;
-  for (int i = 0; i < depth; ++i)
-    std::cout << "  ";
-  std::cout << std::to_string (node->val) << "\n";
-  printSyntaxTree (node->left, depth + 1);
-  printSyntaxTree (node->right, depth + 1);
+  // Explicit stack so that arbitrarily deep trees can be printed
+  std::vector<std::pair<NodeIndex, int> > stack{ { root, 0 } };
+  while (!stack.empty ())
+    {
+      auto [node, depth] = stack.back ();
+      stack.pop_back ();
+      if (node == NO_NODE) continue;
+      for (int i = 0; i < depth; ++i)
+        std::cout << "  ";
+      std::cout << std::to_string (tree.nodes[node].val) << "\n";
+      stack.push_back ({ tree.nodes[node].right, depth + 1 });
+      stack.push_back ({ tree.nodes[node].left, depth + 1 });
+    }
 }
 
-// Forward declaration
-static SynTree *parseExpression (const std::vector<Token> &tokens,
-                                 size_t &idx);
+//! \brief Binding power of a binary operator token
+static inline int
+precedence (TokenType tokenType)
+{
+  return tokenType == TokenType::AND ? 2 : tokenType == TokenType::OR ? 1 : 0;
+}
 
-static SynTree *
-parseFactor (const std::vector<Token> &tokens, size_t &idx)
+//! \brief Parse an expression with an operator precedence (shunting-yard)
+//! \details Operators and operands live on explicit stacks instead of the
+//!          call stack, so nesting depth is only bounded by memory. '!'
+//!          binds tighter than '&', which binds tighter than '|'. Nodes are
+//!          pushed into the pool as they are reduced, which keeps the pool
+//!          in post order. A name followed by '(' calls a definition, its
+//!          arguments are expressions separated by ','. The expression ends
+//!          at the first token that can not continue it, or at a ')' with no
+//!          matching '('.
+template <typename Tokens>
+static NodeIndex
+parseExpression (const Tokens &tokens, size_t &idx, SynTree &tree)
 {
-  if (idx >= tokens.size ())
-    {
-      return nullptr;
-    }
+  std::vector<TokenType> operators;
+  std::vector<NodeIndex> operands;
+
+  // One entry per open '(', the definition it calls, NONE for a plain
+  // group, and the operands below its arguments
+  struct Group
+  {
+    Symbols::Symbol call;
+    size_t operands;
+  };
+  std::vector<Group> groups;
+
+  // Pop the top operator and push its node into the pool
+  auto reduce = [&] () {
+    Algebra operation;
+    operation.type = AlgebraType::OPERATION;
+    operation.operation = tokenToOpType (operators.back ());
+    operators.pop_back ();
+    NodeIndex right = operands.back ();
+    operands.pop_back ();
+    if (operation.operation == OperationType::NOT)
+      {
+        operands.push_back (tree.push (operation, NO_NODE, right));
+        return;
+      }
+    NodeIndex left = operands.back ();
+    operands.pop_back ();
+    operands.push_back (tree.push (operation, left, right));
+  };
+
+  // Apply the pending '!' operators to a completed operand
+  auto reduceNots = [&] () {
+    while (!operators.empty () && operators.back () == TokenType::NOT)
+      reduce ();
+  };
+
+  // Close the innermost '(' and build the call node it belongs to
+  auto closeGroup = [&] () {
+    while (operators.back () != TokenType::PAREN_L)
+      reduce ();
+    operators.pop_back ();
+    Group group = groups.back ();
+    groups.pop_back ();
+    if (group.call != Symbols::NONE)
+      {
+        // Link the arguments back to front, children come before parents
+        Algebra argument;
+        argument.type = AlgebraType::ARGUMENT;
+        NodeIndex next = NO_NODE;
+        for (size_t i = operands.size (); i-- > group.operands;)
+          next = tree.push (argument, operands[i], next);
+        operands.resize (group.operands);
+        Algebra call;
+        call.type = AlgebraType::CALL;
+        call.variable = group.call;
+        operands.push_back (tree.push (call, NO_NODE, next));
+      }
+    reduceNots ();
+  };
 
-  Token token = tokens[idx];
+  // Check if the innermost '(' belongs to a call
+  auto inCall = [&] () {
+    return !groups.empty () && groups.back ().call != Symbols::NONE;
+  };
 
-  if (token.type == TokenType::VAR_NAME)
-    {
-      idx++;
-      Algebra varName;
-      varName.type = AlgebraType::VARIABLE;
-      varName.variable = token.name;
-      return new SynTree (varName);
-    }
-  else if (token.type == TokenType::VAL)
-    {
-      idx++; // Skip '('
-      Algebra value;
-      value.type = AlgebraType::VALUE;
-      value.value = token.val;
-      return new SynTree (value);
-    }
-  else if (token.type == TokenType::PAREN_L)
+  bool expectOperand = true;
+  for (;;)
     {
-      idx++; // Skip '('
-      SynTree *expr = parseExpression (tokens, idx);
-      if (idx >= tokens.size () || tokens[idx].type != TokenType::PAREN_R)
+      if (idx >= tokens.size ())
         {
-          std::cerr << "SYNTAX ERROR: Mismatched parentheses\n";
-          return nullptr;
+          if (expectOperand) return NO_NODE;
+          break;
         }
-      idx++; // Skip ')'
-      return expr;
-    }
-  else if (token.type == TokenType::NOT)
-    {
-      idx++; // Skip '!'
-      SynTree *factor = parseFactor (tokens, idx);
-      Algebra operation;
-      operation.type = AlgebraType::OPERATION;
-      operation.operation = OperationType::NOT;
-      return new SynTree (operation, nullptr, factor);
-    }
-  else
-    {
-      std::cerr << "SYNTAX ERROR: Unexpected token in parseFactor: "
-                << std::to_string (token.type) << '\n';
-      return nullptr;
-    }
-}
-
-static SynTree *
-parseTerm (const std::vector<Token> &tokens, size_t &idx)
-{
-  SynTree *node = parseFactor (tokens, idx);
-  if (!node)
-    {
-      return nullptr;
-    }
+      TokenType type = tokens[idx].type;
 
-  while (idx < tokens.size () && tokens[idx].type != TokenType::QMARK
-         && tokens[idx].type == TokenType::AND)
-    {
-      idx++; // Skip '&'
-      SynTree *right = parseFactor (tokens, idx);
-      if (!right)
+      if (expectOperand)
         {
-          std::cerr
-              << "SYNTAX ERROR: Failed to parse right factor in parseTerm\n";
-          return nullptr;
+          if (type == TokenType::VAR_NAME && idx + 1 < tokens.size ()
+              && tokens[idx + 1].type == TokenType::PAREN_L)
+            {
+              operators.push_back (TokenType::PAREN_L);
+              groups.push_back ({ tokens[idx].symbol, operands.size () });
+              ++idx; // The '(' is skipped below
+            }
+          else if (type == TokenType::PAREN_R && inCall ()
+                   && operands.size () == groups.back ().operands
+                   && operators.back () == TokenType::PAREN_L)
+            {
+              closeGroup (); // A call without arguments
+              expectOperand = false;
+            }
+          else if (type == TokenType::VAR_NAME)
+            {
+              Algebra varName;
+              varName.type = AlgebraType::VARIABLE;
+              varName.variable = tokens[idx].symbol;
+              operands.push_back (tree.push (varName));
+              reduceNots ();
+              expectOperand = false;
+            }
+          else if (type == TokenType::VAL)
+            {
+              Algebra value;
+              value.type = AlgebraType::VALUE;
+              value.value = tokens[idx].val;
+              operands.push_back (tree.push (value));
+              reduceNots ();
+              expectOperand = false;
+            }
+          else if (type == TokenType::NOT || type == TokenType::PAREN_L)
+            {
+              if (type == TokenType::PAREN_L)
+                groups.push_back ({ Symbols::NONE, operands.size () });
+              operators.push_back (type);
+            }
+          else
+            {
+              std::cerr << "SYNTAX ERROR: Unexpected token in expression: "
+                        << std::to_string (type) << '\n';
+              return NO_NODE;
+            }
+          ++idx;
+          continue;
         }
-      Algebra operation;
-      operation.type = AlgebraType::OPERATION;
-      operation.operation = OperationType::AND;
-      node = new SynTree (operation, node, right);
-    }
-  return node;
-}
 
-static SynTree *
-parseExpression (const std::vector<Token> &tokens, size_t &idx)
-{
-  if (tokens.at (idx).type == TokenType::QMARK
-      && tokens.at (idx).type == TokenType::NEWLINE)
-    ++idx;
-
-  SynTree *node = parseTerm (tokens, idx);
-  if (!node)
-    {
-      return nullptr;
+      if (type == TokenType::AND || type == TokenType::OR)
+        {
+          while (!operators.empty ()
+                 && precedence (operators.back ()) >= precedence (type))
+            reduce ();
+          operators.push_back (type);
+          expectOperand = true;
+          ++idx;
+        }
+      else if (type == TokenType::PAREN_R && !groups.empty ())
+        {
+          closeGroup ();
+          ++idx;
+        }
+      else if (type == TokenType::COMMA && inCall ())
+        {
+          while (operators.back () != TokenType::PAREN_L)
+            reduce ();
+          expectOperand = true;
+          ++idx;
+        }
+      else
+        {
+          break;
+        }
     }
 
-  while (idx < tokens.size () && tokens[idx].type != TokenType::QMARK
-         && tokens[idx].type == TokenType::OR)
+  if (!groups.empty ())
     {
-      idx++; // Skip '|'
-      SynTree *right = parseTerm (tokens, idx);
-      if (!right)
-        {
-          std::cerr << "SYNTAX ERROR: Failed to parse right term in "
-                       "parseExpression\n";
-          return nullptr;
-        }
-      Algebra operation;
-      operation.type = AlgebraType::OPERATION;
-      operation.operation = OperationType::OR;
-      node = new SynTree (operation, node, right);
+      std::cerr << "SYNTAX ERROR: Mismatched parentheses\n";
+      return NO_NODE;
     }
-  return node;
+  while (!operators.empty ())
+    reduce ();
+  return operands.back ();
 }
 
+template <typename Tokens>
 static Command
-parseFindCommand (const std::vector<Token> &tokens, size_t &idx)
+parseFindCommand (const Tokens &tokens, size_t &idx)
 {
   Table *table = new Table;
 
@@ -206,17 +291,21 @@ parseFindCommand (const std::vector<Token> &tokens, size_t &idx)
                     << std::to_string (tokens.at (idx).type) << '\n';
           return Command{ nullptr };
         }
-      std::string fileName = fileNameBase + tokens.at (idx).name;
-      FILE *file = fopen (fileName.c_str (), "r");
+      std::string fileName = fileNameBase;
+      fileName += tokens.at (idx).name;
+      Tokenizer::MappedFile *file = Tokenizer::mapFile (fileName.c_str ());
       if (file == nullptr)
         {
           std::cerr << "ERROR: could not open file: " << fileName << '\n';
           return Command{ nullptr };
         }
-      std::vector<Token> *tokens = Tokenizer::tokenize (file);
+      Tokenizer::TokenStream fileTokens
+          = Tokenizer::tokenize (file->data, file->size);
       idx += 2; // must move the index forward twice
       size_t newIdx = 0;
-      return parseFindCommand (*tokens, newIdx);
+      Command command = parseFindCommand (fileTokens, newIdx);
+      delete file;
+      return command;
     }
 
   while (idx < tokens.size ())
@@ -319,15 +408,15 @@ parseFindCommand (const std::vector<Token> &tokens, size_t &idx)
       return Command{ nullptr };
     };
 
-  return Command{ .type = CommandType::FIND, .table = *table, .name = "" };
+  return Command{ .type = CommandType::FIND, .table = *table };
 }
 
+template <typename Tokens>
 static Command
-parseDefCommand (const std::vector<Token> &tokens, size_t &idx)
+parseDefCommand (const Tokens &tokens, size_t &idx)
 {
-  std::vector<std::string> *arguments = new std::vector<std::string>;
-  std::string definitionName;
-  SynTree *definition;
+  std::vector<Symbols::Symbol> arguments;
+  Symbols::Symbol definitionName;
 
   if (tokens.at (idx++).type != TokenType::VAR_NAME)
     {
@@ -338,7 +427,7 @@ parseDefCommand (const std::vector<Token> &tokens, size_t &idx)
     }
   else
     {
-      definitionName = tokens.at (idx - 1).name;
+      definitionName = tokens.at (idx - 1).symbol;
     }
 
   if (tokens.at (idx++).type != TokenType::PAREN_L)
@@ -360,8 +449,7 @@ parseDefCommand (const std::vector<Token> &tokens, size_t &idx)
       auto tokenType = tokens.at (idx).type;
       if (tokenType == TokenType::VAR_NAME)
         {
-          const std::string arg = tokens.at (idx).name;
-          arguments->push_back (arg);
+          arguments.push_back (tokens.at (idx).symbol);
           idx++; // Move to the next token after pushing into arguments
         }
       else if (tokenType == TokenType::COMMA)
@@ -400,8 +488,9 @@ parseDefCommand (const std::vector<Token> &tokens, size_t &idx)
       return Command{ nullptr };
     }
 
-  // Parse the syntax tree definition
-  definition = parseExpression (tokens, idx);
+  // Parse the syntax tree definition into its own node pool
+  SynTree *definition = new SynTree;
+  NodeIndex root = parseExpression (tokens, idx, *definition);
 
   if (tokens.at (idx++).type != TokenType::QMARK)
     {
@@ -409,26 +498,54 @@ parseDefCommand (const std::vector<Token> &tokens, size_t &idx)
       std::cerr << "SYNTAX ERROR: Expected \" , found: "
                 << std::to_string (currTokenType) << ' '
                 << tokens.at (idx).name << '\n';
+      delete definition;
       return Command{ nullptr };
     }
 
-  if (!definition)
+  if (root == NO_NODE)
     {
       std::cerr << "SYNTAX ERROR: failed to parse syntax tree\n";
+      delete definition;
       return Command{
         nullptr,
       };
     }
+  definition->nodes.shrink_to_fit ();
 
-  // printSyntaxTree(definition);
+  // printSyntaxTree(*definition, definition->root ());
   return Command{ .definition = definition,
                   .type = CommandType::DEFINE,
-                  .arguments = *arguments,
+                  .arguments = arguments,
                   .name = definitionName };
 }
 
+//! \brief Parse a quoted file name that ends the line, idx at the "
+//! \return false after reporting a syntax error
+template <typename Tokens>
+static bool
+parseFileName (const Tokens &tokens, size_t &idx, std::string &fileName)
+{
+  if (tokens.at (++idx).type != TokenType::VAR_NAME
+      || tokens.at (idx + 1).type != TokenType::QMARK)
+    {
+      std::cerr << "SYNTAX ERROR: expected quoted file name. Found: "
+                << std::to_string (tokens.at (idx).type) << '\n';
+      return false;
+    }
+  fileName = tokens.at (idx).name;
+  idx += 2;
+  if (idx < tokens.size () && tokens.at (idx++).type != TokenType::NEWLINE)
+    {
+      std::cerr << "SYNTAX ERROR: Expected end of line, found: "
+                << std::to_string (tokens.at (idx - 1).type) << '\n';
+      return false;
+    }
+  return true;
+}
+
+template <typename Tokens>
 static Command
-parseRunCommand (const std::vector<Token> &tokens, size_t &idx)
+parseRunCommand (const Tokens &tokens, size_t &idx)
 {
   if (tokens.at (idx).type != TokenType::VAR_NAME)
     {
@@ -438,9 +555,19 @@ parseRunCommand (const std::vector<Token> &tokens, size_t &idx)
       return Command{ nullptr };
     }
 
-  std::string definitionName = tokens.at (idx++).name;
+  Symbols::Symbol definitionName = tokens.at (idx++).symbol;
   std::vector<unsigned char> values;
 
+  // Batch form, RUN name "file" with one input vector per line or record
+  if (tokens.at (idx).type == TokenType::QMARK)
+    {
+      std::string fileName;
+      if (!parseFileName (tokens, idx, fileName)) return Command{ nullptr };
+      return Command{ .type = CommandType::RUN,
+                      .name = definitionName,
+                      .fileName = dataFilePath (fileName) };
+    }
+
   // Check for left parenthesis
   if (tokens.at (idx++).type != TokenType::PAREN_L)
     {
@@ -494,8 +621,9 @@ parseRunCommand (const std::vector<Token> &tokens, size_t &idx)
                   .name = definitionName };
 }
 
+template <typename Tokens>
 static Command
-parseAllCommand (const std::vector<Token> &tokens, size_t &idx)
+parseAllCommand (const Tokens &tokens, size_t &idx)
 {
   if (tokens.at (idx).type != TokenType::VAR_NAME)
     {
@@ -504,57 +632,140 @@ parseAllCommand (const std::vector<Token> &tokens, size_t &idx)
       return Command{ nullptr };
     }
 
-  std::string name = tokens.at (idx++).name;
+  Symbols::Symbol name = tokens.at (idx++).symbol;
   SynTree *definition = nullptr;
 
+  // File form, ALL name "file" writes the bit-packed truth table
+  std::string fileName;
+  if (idx < tokens.size () && tokens.at (idx).type == TokenType::QMARK
+      && !parseFileName (tokens, idx, fileName))
+    return Command{ nullptr };
+
+  // Aggregate forms, ALL name COUNT and ALL name FIRST k
+  AllMode mode = AllMode::ROWS;
+  uint64_t limit = 0;
+  if (fileName.empty () && idx < tokens.size ()
+      && tokens.at (idx).type == TokenType::VAR_NAME)
+    {
+      std::string_view word = tokens.at (idx++).name;
+      if (word == "COUNT")
+        {
+          mode = AllMode::COUNT;
+        }
+      else if (word == "FIRST")
+        {
+          mode = AllMode::FIRST;
+          if (idx >= tokens.size ()
+              || (tokens.at (idx).type != TokenType::VAR_NAME
+                  && tokens.at (idx).type != TokenType::VAL))
+            {
+              std::cerr << "SYNTAX ERROR: ALL " << Symbols::name (name)
+                        << " FIRST is missing its row count k\n";
+              return Command{ nullptr };
+            }
+          std::string_view number = tokens.at (idx).name;
+          auto parsed = std::from_chars (
+              number.data (), number.data () + number.size (), limit);
+          if (tokens.at (idx).type == TokenType::VAL)
+            limit = tokens.at (idx).val; // 0 and 1 are values
+          else if (parsed.ec != std::errc ()
+                   || parsed.ptr != number.data () + number.size ())
+            {
+              std::cerr << "SYNTAX ERROR: expected a row count after FIRST, "
+                           "found: "
+                        << number << '\n';
+              return Command{ nullptr };
+            }
+          ++idx;
+        }
+      else
+        {
+          std::cerr << "SYNTAX ERROR: expected COUNT or FIRST after ALL "
+                    << Symbols::name (name) << ", found: " << word << '\n';
+          return Command{ nullptr };
+        }
+    }
+
   return Command{ .definition = definition,
                   .type = CommandType::ALL,
-                  .name = name };
-}
+                  .name = name,
+                  .fileName = fileName,
+                  .mode = mode,
+                  .limit = limit };
 }
 
-/*----------------------------------------------------------------------/
- *------------------------------MODULE EXPR-----------------------------/
- *---------------------------------------------------------------------*/
+//! \brief Parse LOAD name "file", a truth table written by ALL
+template <typename Tokens>
+static Command
+parseLoadCommand (const Tokens &tokens, size_t &idx)
+{
+  if (tokens.at (idx).type != TokenType::VAR_NAME
+      || tokens.at (idx + 1).type != TokenType::QMARK)
+    {
+      std::cerr << "SYNTAX ERROR: definition name and quoted file name "
+                   "expected, found: "
+                << std::to_string (tokens.at (idx).type) << '\n';
+      return Command{ nullptr };
+    }
 
-//! \brief Parse tokens
-extern std::pair<size_t, Command>
-parse (size_t idx, std::vector<Token> *tokens)
+  Symbols::Symbol name = tokens.at (idx++).symbol;
+  std::string fileName;
+  if (!parseFileName (tokens, idx, fileName)) return Command{ nullptr };
+  return Command{ .type = CommandType::LOAD,
+                  .name = name,
+                  .fileName = dataFilePath (fileName) };
+}
+
+//! \brief Parse the command starting at idx
+template <typename Tokens>
+static std::pair<size_t, Command>
+parseCommand (size_t idx, const Tokens &tokens)
 {
-  if (idx >= tokens->size ())
+  if (idx >= tokens.size ())
     {
       // std::cerr << "SYNTAX ERROR: No command found\n";
       return std::pair (idx, Command{ .type = CommandType::EXIT });
     }
 
-  TokenType commandTypeRaw = tokens->at (idx++).type;
+  TokenType commandTypeRaw = tokens.at (idx++).type;
 
   switch (commandTypeRaw)
     {
     case TokenType::DEFINE:
       {
-        return std::pair (idx, parseDefCommand (*tokens, idx));
+        Command command = parseDefCommand (tokens, idx);
+        return std::pair (idx, command);
       }
       break; // END DEFINE
 
     case TokenType::RUN:
       {
-        return std::pair (idx, parseRunCommand (*tokens, idx));
+        Command command = parseRunCommand (tokens, idx);
+        return std::pair (idx, command);
       }
       break; // END RUN
 
     case TokenType::ALL:
       {
-        return std::pair (idx, parseAllCommand (*tokens, idx));
+        Command command = parseAllCommand (tokens, idx);
+        return std::pair (idx, command);
       }
       break; // end ALL
 
     case TokenType::FIND:
       {
-        return std::pair (idx, parseFindCommand (*tokens, idx));
+        Command command = parseFindCommand (tokens, idx);
+        return std::pair (idx, command);
       }
       break; // END FIND
 
+    case TokenType::LOAD:
+      {
+        Command command = parseLoadCommand (tokens, idx);
+        return std::pair (idx, command);
+      }
+      break; // END LOAD
+
     case TokenType::NEWLINE:
       {
         return std::pair (idx, Command{ .type = CommandType::TRIVIAL });
@@ -568,13 +779,52 @@ parse (size_t idx, std::vector<Token> *tokens)
       break; // CLEAR
 
     default:
-      std::cerr << "SYNTAX ERROR: Command must start with DEFINE, RUN, CLEAR "
-                   "or ALL\n";
+      std::cerr << "SYNTAX ERROR: Command must start with DEFINE, RUN, CLEAR, "
+                   "LOAD or ALL\n";
       return std::pair (idx, Command{ .type = CommandType::TRIVIAL });
     }
 }
 }
 
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE EXPR-----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Parse tokens
+extern std::pair<size_t, Command>
+parse (size_t idx, std::vector<Token> *tokens)
+{
+  return parseCommand (idx, *tokens);
+}
+
+//! \brief Parse a compact token stream
+extern std::pair<size_t, Command>
+parse (size_t idx, const Tokenizer::TokenStream *tokens)
+{
+  return parseCommand (idx, *tokens);
+}
+
+//! \brief Bind variable leaves to their argument slot
+extern size_t
+bindArguments (SynTree &tree, const std::vector<Symbols::Symbol> &arguments)
+{
+  size_t unbound = 0;
+  for (SynNode &node : tree.nodes)
+    {
+      if (node.val.type != AlgebraType::VARIABLE) continue;
+      node.slot = NO_SLOT;
+      for (size_t i = 0; i < arguments.size (); ++i)
+        if (arguments[i] == node.val.variable)
+          {
+            node.slot = i;
+            break;
+          }
+      if (node.slot == NO_SLOT) ++unbound;
+    }
+  return unbound;
+}
+}
+
 /*----------------------------------------------------------------------/
  *-----------------------------------EOF--------------------------------/
  *---------------------------------------------------------------------*/
\ No newline at end of file
@@ -0,0 +1,231 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file simplify.cpp
+ * \author Delyan Kirov
+ * \brief Implementation of the Boolean simplification of syntax trees
+ *---------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+
+#include "simplify.hpp"
+#include "parser.hpp"
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Simplify
+{
+namespace
+{
+using Parser::Algebra;
+using Parser::AlgebraType;
+using Parser::NodeIndex;
+using Parser::OperationType;
+using Parser::SynNode;
+
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE TYPES-------------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Structural key of a node, children already shared
+struct Key
+{
+  uint64_t kind;
+  uint64_t children;
+
+  bool
+  operator== (const Key &other) const
+  {
+    return kind == other.kind && children == other.children;
+  }
+};
+
+struct KeyHash
+{
+  size_t
+  operator() (const Key &key) const
+  {
+    return key.kind * 0x9E3779B97F4A7C15ull ^ key.children;
+  }
+};
+
+//! \brief Rebuilds a pool bottom up, simplifying every new node
+struct Builder
+{
+  std::vector<SynNode> nodes{};
+  std::unordered_map<Key, NodeIndex, KeyHash> shared{};
+
+  //! \brief Add a node, or return the equal one already built
+  NodeIndex
+  make (const SynNode &node)
+  {
+    Key key{ uint64_t (node.val.type) << 16
+                 | uint64_t (node.val.operation) << 8 | node.val.value,
+             uint64_t (node.left) << 32 | node.right };
+    auto found = shared.find (key);
+    if (found != shared.end ()) return found->second;
+    nodes.push_back (node);
+    shared.emplace (key, nodes.size () - 1);
+    return nodes.size () - 1;
+  }
+
+  NodeIndex
+  value (unsigned char constant)
+  {
+    Algebra val;
+    val.type = AlgebraType::VALUE;
+    val.value = constant;
+    return make ({ val, { Parser::NO_NODE }, Parser::NO_NODE });
+  }
+
+  bool
+  isValue (NodeIndex index, unsigned char constant) const
+  {
+    return nodes[index].val.type == AlgebraType::VALUE
+           && nodes[index].val.value == constant;
+  }
+
+  bool
+  isOperation (NodeIndex index, OperationType operation) const
+  {
+    return nodes[index].val.type == AlgebraType::OPERATION
+           && nodes[index].val.operation == operation;
+  }
+
+  //! \brief Check if one node is the NOT of the other
+  bool
+  complements (NodeIndex a, NodeIndex b) const
+  {
+    return (isOperation (a, OperationType::NOT) && nodes[a].right == b)
+           || (isOperation (b, OperationType::NOT) && nodes[b].right == a);
+  }
+
+  NodeIndex
+  negation (NodeIndex operand)
+  {
+    if (nodes[operand].val.type == AlgebraType::VALUE)
+      return value (!nodes[operand].val.value);
+    if (isOperation (operand, OperationType::NOT)) // !!x = x
+      return nodes[operand].right;
+
+    Algebra val;
+    val.type = AlgebraType::OPERATION;
+    val.operation = OperationType::NOT;
+    return make ({ val, { Parser::NO_NODE }, operand });
+  }
+
+  //! \brief AND or OR of two simplified nodes
+  NodeIndex
+  binary (OperationType operation, NodeIndex a, NodeIndex b)
+  {
+    OperationType dual = operation == OperationType::AND ? OperationType::OR
+                                                         : OperationType::AND;
+    unsigned char identity = operation == OperationType::AND;
+    unsigned char absorbing = !identity;
+
+    for (int side = 0; side < 2; ++side, std::swap (a, b))
+      {
+        // x & 1 = x, x | 0 = x
+        if (isValue (a, identity)) return b;
+        // x & 0 = 0, x | 1 = 1
+        if (isValue (a, absorbing)) return a;
+
+        bool sameOperation = isOperation (b, operation);
+        if (!sameOperation && !isOperation (b, dual)) continue;
+        NodeIndex b0 = nodes[b].left, b1 = nodes[b].right;
+        bool contains = a == b0 || a == b1;
+        // x & (x & y) = x & y
+        if (sameOperation && contains) return b;
+        // x & (x | y) = x
+        if (!sameOperation && contains) return a;
+        // x & (!x & y) = 0
+        if (sameOperation && (complements (a, b0) || complements (a, b1)))
+          return value (absorbing);
+      }
+
+    // x & x = x
+    if (a == b) return a;
+    // x & !x = 0
+    if (complements (a, b)) return value (absorbing);
+
+    Algebra val;
+    val.type = AlgebraType::OPERATION;
+    val.operation = operation;
+    if (a > b) std::swap (a, b); // Commuted operands share one node
+    return make ({ val, { a }, b });
+  }
+};
+} // end namespace
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE EXPR-----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Simplify a bound syntax tree in place
+extern void
+simplify (Parser::SynTree &tree)
+{
+  if (tree.nodes.empty ()) return;
+
+  // The pool is in post order, so children are rebuilt before parents
+  Builder builder;
+  std::vector<NodeIndex> rebuilt (tree.nodes.size ());
+  for (size_t i = 0; i < tree.nodes.size (); ++i)
+    {
+      const SynNode &node = tree.nodes[i];
+      switch (node.val.type)
+        {
+        case AlgebraType::VALUE:
+          rebuilt[i] = builder.value (node.val.value != 0);
+          break;
+        case AlgebraType::VARIABLE:
+          rebuilt[i] = builder.make (node);
+          break;
+        case AlgebraType::OPERATION:
+          if (node.val.operation == OperationType::NOT)
+            rebuilt[i] = builder.negation (rebuilt[node.right]);
+          else
+            rebuilt[i] = builder.binary (node.val.operation,
+                                         rebuilt[node.left],
+                                         rebuilt[node.right]);
+          break;
+        default: return; // Leave a malformed pool alone
+        }
+    }
+
+  // Keep the nodes reachable from the root, the root last
+  std::vector<SynNode> &nodes = builder.nodes;
+  NodeIndex root = rebuilt.back ();
+  std::vector<bool> live (root + 1, false);
+  live[root] = true;
+  for (size_t i = root + 1; i-- > 0;)
+    {
+      if (!live[i] || nodes[i].val.type != AlgebraType::OPERATION) continue;
+      live[nodes[i].right] = true;
+      if (nodes[i].val.operation != OperationType::NOT)
+        live[nodes[i].left] = true;
+    }
+
+  std::vector<NodeIndex> compact (root + 1, Parser::NO_NODE);
+  tree.nodes.clear ();
+  for (size_t i = 0; i <= root; ++i)
+    {
+      if (!live[i]) continue;
+      SynNode node = nodes[i];
+      if (node.val.type == AlgebraType::OPERATION)
+        {
+          node.right = compact[node.right];
+          if (node.val.operation != OperationType::NOT)
+            node.left = compact[node.left];
+        }
+      compact[i] = tree.nodes.size ();
+      tree.nodes.push_back (node);
+    }
+  tree.nodes.shrink_to_fit ();
+}
+} // end namespace Simplify
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
@@ -0,0 +1,65 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file symbols.cpp
+ * \author Delyan Kirov
+ * \brief Implementation of the interned symbol table
+ *---------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+
+#include "symbols.hpp"
+#include <deque>
+#include <unordered_map>
+
+namespace Symbols
+{
+namespace
+{
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE DATA-----------------------------/
+ *---------------------------------------------------------------------*/
+
+// A deque never moves its elements, so the views used as keys stay valid
+std::deque<std::string> names;
+std::unordered_map<std::string_view, Symbol> ids;
+
+const std::string noName = "";
+}
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE EXPR-----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Return the id of name, adding it to the table if needed
+extern Symbol
+intern (std::string_view name)
+{
+  auto found = ids.find (name);
+  if (found != ids.end ()) return found->second;
+
+  Symbol symbol = names.size ();
+  names.emplace_back (name);
+  ids.emplace (names.back (), symbol);
+  return symbol;
+}
+
+//! \brief Return the identifier of an interned id
+extern const std::string &
+name (Symbol symbol)
+{
+  if (symbol >= names.size ()) return noName;
+  return names[symbol];
+}
+
+//! \brief Return the number of interned identifiers
+extern size_t
+count ()
+{
+  return names.size ();
+}
+} // end namespace Symbols
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
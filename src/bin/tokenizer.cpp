@@ -9,17 +9,130 @@
  *---------------------------------------------------------------------*/
 
 #include "tokenizer.hpp"
+#include <algorithm>
 #include <cctype>
 #include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
 #include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
 #include <vector>
 
+namespace Tokenizer
+{
+namespace
+{
 /*----------------------------------------------------------------------/
- *------------------------------MODULE EXPR-----------------------------/
+ *---------------------------MODULE DEFINES-----------------------------/
  *---------------------------------------------------------------------*/
 
-namespace Tokenizer
+//! \brief Inputs smaller than this are not worth splitting over threads
+constexpr size_t parallelMinSize = 1 << 20;
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE IMPL-----------------------------/
+ *---------------------------------------------------------------------*/
+
+static inline void
+pushToken (TokenStream &stream, TokenType type, size_t offset, size_t length,
+           Symbols::Symbol symbol = Symbols::NONE)
+{
+  stream.types.push_back (type);
+  stream.offsets.push_back (offset);
+  stream.lengths.push_back (length);
+  stream.symbols.push_back (symbol);
+}
+
+//! \brief Classify and push the pending name buffer[start, end)
+template <typename Intern>
+static inline void
+pushName (TokenStream &stream, const char *buffer, size_t start, size_t end,
+          Intern &intern)
 {
+  std::string_view name (buffer + start, end - start);
+  TokenType type;
+  if (name == "DEFINE")
+    type = TokenType::DEFINE;
+  else if (name == "RUN")
+    type = TokenType::RUN;
+  else if (name == "FIND")
+    type = TokenType::FIND;
+  else if (name == "CLEAR")
+    type = TokenType::CLEAR;
+  else if (name == "ALL")
+    type = TokenType::ALL;
+  else if (name == "LOAD")
+    type = TokenType::LOAD;
+  else if (name == "1" || name == "0")
+    type = TokenType::VAL;
+  else
+    {
+      pushToken (stream, TokenType::VAR_NAME, start, end - start,
+                 intern (name));
+      return;
+    }
+  pushToken (stream, type, start, end - start);
+}
+
+//! \brief Tokenize buffer[begin, end) into stream
+//! \param intern maps each name to the symbol stored in the stream
+//! \return end on success, otherwise the offset of the offending character
+template <typename Intern>
+static size_t
+tokenizeRange (const char *buffer, size_t begin, size_t end,
+               TokenStream &stream, Intern &&intern)
+{
+  size_t nameStart = begin;
+  bool inName = false;
+
+  for (size_t i = begin; i < end; ++i)
+    {
+      unsigned char c = buffer[i];
+      if (isalnum (c) || c == '.')
+        {
+          if (!inName) nameStart = i;
+          inName = true;
+          continue;
+        }
+
+      if (inName)
+        {
+          pushName (stream, buffer, nameStart, i, intern);
+          inName = false;
+        }
+
+      TokenType type;
+      switch (c)
+        {
+        case '&' : type = TokenType::AND; break;
+        case '|' : type = TokenType::OR; break;
+        case '!' : type = TokenType::NOT; break;
+        case '(' : type = TokenType::PAREN_L; break;
+        case ')' : type = TokenType::PAREN_R; break;
+        case ':' : type = TokenType::COLS; break;
+        case ';' : type = TokenType::SEMICOLS; break;
+        case '"' : type = TokenType::QMARK; break;
+        case ',' : type = TokenType::COMMA; break;
+        case '\n': type = TokenType::NEWLINE; break;
+        case ' ' : continue;
+        default  : return i;
+        }
+      pushToken (stream, type, i, 1);
+    }
+
+  if (inName) pushName (stream, buffer, nameStart, end, intern);
+  return end;
+}
+} // end namespace
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE EXPR-----------------------------/
+ *---------------------------------------------------------------------*/
+
 extern void
 printTokens (const std::vector<Token> &tokens)
 {
@@ -36,102 +149,199 @@ printTokens (const std::vector<Token> &tokens)
 extern std::vector<Token> *
 tokenize (FILE *file)
 {
+  std::string buffer;
+  {
+    char chunk[4096];
+    size_t read;
+    while ((read = fread (chunk, 1, sizeof (chunk), file)) > 0)
+      buffer.append (chunk, read);
+  }
+
+  TokenStream stream = tokenize (buffer.data (), buffer.size ());
   auto tokens = new std::vector<Token>;
-  Token newToken;
-  std::string tokenName;
+  tokens->reserve (stream.size ());
+  for (size_t i = 0; i < stream.size (); ++i)
+    {
+      TokenView token = stream[i];
+      tokens->push_back (
+          { token.type, token.val, std::string (token.name), token.symbol });
+    }
+  return tokens;
+}
 
-  int c;
-  while ((c = fgetc (file)) != EOF)
+//! \brief Function to tokenize an in-memory buffer into a compact stream
+extern TokenStream
+tokenize (const char *buffer, size_t size)
+{
+  if (size > UINT32_MAX)
     {
-      // std::cout << (char)c;
-      if (isalnum (c) || c == '.')
-        {
-          tokenName += (char)c;
-        }
-      else if (c == '&')
-        {
-          tokens->push_back ({ TokenType::AND, 2, "" });
-        }
-      else if (c == '|')
-        {
-          tokens->push_back ({ TokenType::OR, 2, "" });
-        }
-      else if (c == '!')
-        {
-          tokens->push_back ({ TokenType::NOT, 2, "" });
-        }
-      else if (c == ' ' || c == '(' || c == ')' || c == ',' || c == '"'
-               || c == ':' || c == ';' || c == '\n')
-        {
-          if (tokenName == "DEFINE")
-            {
-              tokens->push_back ({ TokenType::DEFINE, 2, "" });
-            }
-          else if (tokenName == "RUN")
-            {
-              tokens->push_back ({ TokenType::RUN, 2, "" });
-            }
-          else if (tokenName == "FIND")
-            {
-              tokens->push_back ({ TokenType::FIND, 2, "" });
-            }
-          else if (tokenName == "CLEAR")
-            {
-              tokens->push_back ({ TokenType::CLEAR, 2, "" });
-            }
-          else if (tokenName == "ALL")
-            {
-              tokens->push_back ({ TokenType::ALL, 2, "" });
-            }
-          else if (tokenName != "" && tokenName != "1" && tokenName != "0")
-            {
-              tokens->push_back ({ TokenType::VAR_NAME, 2, tokenName });
-            }
-          else if (tokenName == "1")
-            {
-              tokens->push_back ({ TokenType::VAL, 1, "" });
-            }
-          else if (tokenName == "0")
-            {
-              tokens->push_back ({ TokenType::VAL, 0, "" });
-            }
-          tokenName = "";
-        }
-      else
-        {
-          std::cerr << "ERROR: Unrecognized token: " << (char)c << '\n';
-          exit (1);
-        }
-      if (c == '(')
-        {
-          tokens->push_back ({ TokenType::PAREN_L, 2, "" });
-        }
-      else if (c == ')')
-        {
-          tokens->push_back ({ TokenType::PAREN_R, 2, "" });
-        }
-      else if (c == ':')
-        {
-          tokens->push_back ({ TokenType::COLS, 2, "" });
-        }
-      else if (c == ';')
-        {
-          tokens->push_back ({ TokenType::SEMICOLS, 2, "" });
-        }
-      else if (c == '"')
-        {
-          tokens->push_back ({ TokenType::QMARK, 2, "" });
-        }
-      else if (c == ',')
-        {
-          tokens->push_back ({ TokenType::COMMA, 2, "" });
-        }
-      else if (c == '\n')
+      std::cerr << "ERROR: input larger than 4 GiB can not be tokenized\n";
+      exit (1);
+    }
+
+  TokenStream stream;
+  stream.buffer = buffer;
+  // Roughly one token every four bytes in typical scripts
+  stream.types.reserve (size / 4);
+  stream.offsets.reserve (size / 4);
+  stream.lengths.reserve (size / 4);
+  stream.symbols.reserve (size / 4);
+
+  size_t failedAt = tokenizeRange (buffer, 0, size, stream, Symbols::intern);
+  if (failedAt != size)
+    {
+      std::cerr << "ERROR: Unrecognized token: " << buffer[failedAt] << '\n';
+      exit (1);
+    }
+  return stream;
+}
+
+//! \brief Tokenize an in-memory buffer on several threads
+//! \details The buffer is split into newline aligned chunks, the tokenizer
+//!          carries no state over a newline, so every chunk is tokenized
+//!          on its own. Names are interned per chunk and merged in chunk
+//!          order, giving the same ids as the serial path.
+extern TokenStream
+tokenizeParallel (const char *buffer, size_t size, unsigned threads)
+{
+  if (threads <= 1 || size < parallelMinSize)
+    return tokenize (buffer, size);
+
+  if (size > UINT32_MAX)
+    {
+      std::cerr << "ERROR: input larger than 4 GiB can not be tokenized\n";
+      exit (1);
+    }
+
+  // Chunk boundaries, each one right after a newline
+  std::vector<size_t> bounds{ 0 };
+  for (unsigned i = 1; i < threads; ++i)
+    {
+      size_t bound = std::max (bounds.back (), size * i / threads);
+      const void *newline = memchr (buffer + bound, '\n', size - bound);
+      if (newline == nullptr) break;
+      bound = static_cast<const char *> (newline) - buffer + 1;
+      if (bound > bounds.back ()) bounds.push_back (bound);
+    }
+  bounds.push_back (size);
+  size_t chunks = bounds.size () - 1;
+
+  struct Chunk
+  {
+    TokenStream stream;
+    std::unordered_map<std::string_view, Symbols::Symbol> ids;
+    std::vector<std::string_view> names; // Local id -> name
+    size_t failedAt;
+  };
+  std::vector<Chunk> parts (chunks);
+
+  {
+    std::vector<std::thread> workers;
+    for (size_t c = 0; c < chunks; ++c)
+      workers.emplace_back ([&, c] () {
+        Chunk &part = parts[c];
+        size_t estimate = (bounds[c + 1] - bounds[c]) / 4;
+        part.stream.types.reserve (estimate);
+        part.stream.offsets.reserve (estimate);
+        part.stream.lengths.reserve (estimate);
+        part.stream.symbols.reserve (estimate);
+        part.failedAt = tokenizeRange (
+            buffer, bounds[c], bounds[c + 1], part.stream,
+            [&part] (std::string_view name) {
+              auto found = part.ids.emplace (name, part.names.size ());
+              if (found.second) part.names.push_back (name);
+              return found.first->second;
+            });
+      });
+    for (auto &worker : workers)
+      worker.join ();
+  }
+
+  // Report the first error like the serial tokenizer would
+  for (size_t c = 0; c < chunks; ++c)
+    if (parts[c].failedAt != bounds[c + 1])
+      {
+        std::cerr << "ERROR: Unrecognized token: "
+                  << buffer[parts[c].failedAt] << '\n';
+        exit (1);
+      }
+
+  // Merge the local symbols in order and stitch the chunks together
+  TokenStream stream;
+  stream.buffer = buffer;
+  std::vector<size_t> starts (chunks + 1, 0);
+  std::vector<std::vector<Symbols::Symbol> > remaps (chunks);
+  for (size_t c = 0; c < chunks; ++c)
+    {
+      starts[c + 1] = starts[c] + parts[c].stream.size ();
+      for (std::string_view name : parts[c].names)
+        remaps[c].push_back (Symbols::intern (name));
+    }
+  stream.types.resize (starts[chunks]);
+  stream.offsets.resize (starts[chunks]);
+  stream.lengths.resize (starts[chunks]);
+  stream.symbols.resize (starts[chunks]);
+
+  {
+    std::vector<std::thread> workers;
+    for (size_t c = 0; c < chunks; ++c)
+      workers.emplace_back ([&, c] () {
+        const TokenStream &part = parts[c].stream;
+        size_t start = starts[c];
+        std::copy (part.types.begin (), part.types.end (),
+                   stream.types.begin () + start);
+        std::copy (part.offsets.begin (), part.offsets.end (),
+                   stream.offsets.begin () + start);
+        std::copy (part.lengths.begin (), part.lengths.end (),
+                   stream.lengths.begin () + start);
+        for (size_t i = 0; i < part.size (); ++i)
+          {
+            Symbols::Symbol symbol = part.symbols[i];
+            stream.symbols[start + i]
+                = symbol == Symbols::NONE ? symbol : remaps[c][symbol];
+          }
+      });
+    for (auto &worker : workers)
+      worker.join ();
+  }
+  return stream;
+}
+
+//! \brief Map a regular file into memory, nullptr if it can not be mapped
+extern MappedFile *
+mapFile (const char *fileName)
+{
+  int fd = open (fileName, O_RDONLY);
+  if (fd < 0) return nullptr;
+
+  struct stat info;
+  if (fstat (fd, &info) != 0 || !S_ISREG (info.st_mode))
+    {
+      close (fd);
+      return nullptr;
+    }
+
+  auto mapped = new MappedFile;
+  mapped->size = info.st_size;
+  if (mapped->size > 0)
+    {
+      void *data = mmap (nullptr, mapped->size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED)
         {
-          tokens->push_back ({ TokenType::NEWLINE, 2, "" });
+          close (fd);
+          delete mapped;
+          return nullptr;
         }
+      madvise (data, mapped->size, MADV_SEQUENTIAL);
+      mapped->data = static_cast<const char *> (data);
     }
-  return tokens;
+  close (fd);
+  return mapped;
+}
+
+MappedFile::~MappedFile ()
+{
+  if (data != nullptr) munmap (const_cast<char *> (data), size);
 }
 } // end namespace Tokenizer
 
@@ -0,0 +1,448 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file vm.cpp
+ * \author Delyan Kirov
+ * \brief Implementation of the postfix bytecode evaluator
+ *---------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+
+#include "vm.hpp"
+#include "aig.hpp"
+#include "parser.hpp"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace Vm
+{
+namespace
+{
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE TYPES-------------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Node of the DAG handed to the code generator
+//! \details CONST and LOAD keep their operand in a, NOT its operand in a,
+//!          AND and OR their operands in a and b.
+struct Step
+{
+  Op op;
+  uint32_t a;
+  uint32_t b;
+};
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE IMPL-----------------------------/
+ *---------------------------------------------------------------------*/
+
+static inline bool
+isLeaf (const Step &step)
+{
+  return step.op == CONST || step.op == LOAD;
+}
+
+//! \brief Emit postfix code for a DAG in topological order, root last
+//! \details A depth first walk with an explicit stack. Operations used more
+//!          than once are stored in a temporary the first time and loaded
+//!          from it afterwards.
+static Program *
+generate (const std::vector<Step> &steps, uint32_t inputs)
+{
+  Program *program = new Program;
+  program->inputs = inputs;
+  if (steps.empty ())
+    {
+      program->storage.push_back (encode (CONST, 0));
+      program->code = program->storage;
+      program->maxStack = 1;
+      return program;
+    }
+
+  // Fanout of every step reachable from the root
+  std::vector<uint32_t> fanout (steps.size (), 0);
+  fanout.back () = 1;
+  for (size_t i = steps.size (); i-- > 0;)
+    {
+      if (fanout[i] == 0 || isLeaf (steps[i])) continue;
+      ++fanout[steps[i].a];
+      if (steps[i].op != NOT) ++fanout[steps[i].b];
+    }
+
+  constexpr uint32_t noTemp = UINT32_MAX;
+  std::vector<uint32_t> temp (steps.size (), noTemp);
+  uint32_t depth = 0;
+  auto emit = [&] (Instruction instruction, int delta) {
+    program->storage.push_back (instruction);
+    depth += delta;
+    program->maxStack = std::max (program->maxStack, depth);
+  };
+
+  // Each entry is a step and whether its operands were already emitted
+  std::vector<std::pair<uint32_t, bool> > stack{ { steps.size () - 1,
+                                                   false } };
+  while (!stack.empty ())
+    {
+      auto [index, expanded] = stack.back ();
+      stack.pop_back ();
+      const Step &step = steps[index];
+
+      if (!expanded)
+        {
+          if (temp[index] != noTemp)
+            emit (encode (TEMP, temp[index]), 1);
+          else if (isLeaf (step))
+            emit (encode (step.op, step.a), 1);
+          else
+            {
+              stack.push_back ({ index, true });
+              if (step.op != NOT) stack.push_back ({ step.b, false });
+              stack.push_back ({ step.a, false });
+            }
+          continue;
+        }
+
+      emit (encode (step.op), step.op == NOT ? 0 : -1);
+      if (fanout[index] > 1)
+        {
+          temp[index] = program->temps++;
+          emit (encode (STORE, temp[index]), 0);
+        }
+    }
+  program->code = program->storage;
+  return program;
+}
+
+//! \brief Word of one bound node, its children already evaluated
+static inline uint64_t
+nodeWord (const Parser::SynNode &node, const uint64_t *inputs,
+          const uint64_t *values)
+{
+  using Parser::AlgebraType;
+  using Parser::OperationType;
+
+  switch (node.val.type)
+    {
+    case AlgebraType::VALUE   : return node.val.value ? ~0ull : 0;
+    case AlgebraType::VARIABLE: return inputs[node.slot];
+    default:
+      switch (node.val.operation)
+        {
+        case OperationType::AND:
+          return values[node.left] & values[node.right];
+        case OperationType::OR: return values[node.left] | values[node.right];
+        default               : return ~values[node.right];
+        }
+    }
+}
+} // end namespace
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE EXPR-----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Compile bound syntax tree nodes, nullptr if a variable is unbound
+extern Program *
+compile (Parser::NodeSpan nodes, uint32_t inputs)
+{
+  using Parser::AlgebraType;
+  using Parser::OperationType;
+
+  std::vector<Step> steps;
+  steps.reserve (nodes.size ());
+  for (const Parser::SynNode &node : nodes)
+    {
+      switch (node.val.type)
+        {
+        case AlgebraType::VALUE:
+          steps.push_back ({ CONST, node.val.value != 0, 0 });
+          break;
+        case AlgebraType::VARIABLE:
+          if (node.slot == Parser::NO_SLOT) return nullptr;
+          steps.push_back ({ LOAD, node.slot, 0 });
+          break;
+        case AlgebraType::OPERATION:
+          switch (node.val.operation)
+            {
+            case OperationType::AND:
+              steps.push_back ({ AND, node.left, node.right });
+              break;
+            case OperationType::OR:
+              steps.push_back ({ OR, node.left, node.right });
+              break;
+            case OperationType::NOT:
+              steps.push_back ({ NOT, node.right, 0 });
+              break;
+            }
+          break;
+        default: return nullptr;
+        }
+    }
+  return generate (steps, inputs);
+}
+
+//! \brief Compile an And-Inverter Graph
+extern Program *
+compile (const Aig::Graph &graph)
+{
+  using Aig::Literal;
+
+  // Steps 0..inputs mirror the graph nodes, complements are NOT steps
+  std::vector<Step> steps;
+  steps.push_back ({ CONST, 0, 0 });
+  for (uint32_t i = 0; i < graph.inputs; ++i)
+    steps.push_back ({ LOAD, i, 0 });
+
+  std::vector<uint32_t> positive (graph.nodes.size ());
+  std::vector<uint32_t> negative (graph.nodes.size (), UINT32_MAX);
+  for (uint32_t i = 0; i <= graph.inputs; ++i)
+    positive[i] = i;
+
+  auto step = [&] (Literal literal) {
+    uint32_t node = Aig::nodeOf (literal);
+    if (!Aig::isComplemented (literal)) return positive[node];
+    if (negative[node] == UINT32_MAX)
+      {
+        negative[node] = steps.size ();
+        steps.push_back ({ NOT, positive[node], 0 });
+      }
+    return negative[node];
+  };
+
+  for (size_t i = graph.inputs + 1; i < graph.nodes.size (); ++i)
+    {
+      uint32_t left = step (graph.nodes[i].left);
+      uint32_t right = step (graph.nodes[i].right);
+      positive[i] = steps.size ();
+      steps.push_back ({ AND, left, right });
+    }
+
+  // Make the output the last step
+  uint32_t output = step (graph.output);
+  if (output != steps.size () - 1)
+    {
+      Step copy = steps[output];
+      steps.push_back (copy);
+    }
+  return generate (steps, graph.inputs);
+}
+
+//! \brief Evaluate every row of a program into a truth table
+extern TruthTable *
+tabulate (const Program &program)
+{
+  if (program.inputs > maxTableInputs) return nullptr;
+
+  const Kernel &kernel = widestKernel ();
+  uint64_t rows = uint64_t (1) << program.inputs;
+  uint64_t blockRows = uint64_t (kernel.words) * sliceLanes;
+  std::vector<uint64_t> inputs (program.inputs * kernel.words);
+  std::vector<uint64_t> results (kernel.words);
+
+  TruthTable *table = new TruthTable;
+  table->inputs = program.inputs;
+  std::vector<uint64_t> &bits = table->storage;
+  bits.resize ((rows + sliceLanes - 1) / sliceLanes);
+  for (uint64_t first = 0; first < rows; first += blockRows)
+    {
+      sliceBlock (program.inputs, kernel.words, first,
+                  first == 0 ? ~first : first - blockRows, inputs.data ());
+      kernel.run (program, inputs.data (), results.data ());
+      uint64_t words = std::min<uint64_t> (kernel.words,
+                                           bits.size () - first / 64);
+      std::copy (results.begin (), results.begin () + words,
+                 bits.begin () + first / 64);
+    }
+  if (rows < sliceLanes) bits[0] &= (uint64_t (1) << rows) - 1;
+  table->bits = bits;
+  return table;
+}
+
+//! \brief Find the cone of every input of bound syntax tree nodes
+extern Cones *
+cones (Parser::NodeSpan nodes, uint32_t inputs)
+{
+  using Parser::AlgebraType;
+  using Parser::OperationType;
+
+  if (inputs > 64) return nullptr;
+
+  // Inputs every node depends on, one bit per input
+  std::vector<uint64_t> depends (nodes.size (), 0);
+  for (size_t i = 0; i < nodes.size (); ++i)
+    {
+      const Parser::SynNode &node = nodes[i];
+      switch (node.val.type)
+        {
+        case AlgebraType::VALUE: break;
+        case AlgebraType::VARIABLE:
+          if (node.slot >= inputs) return nullptr;
+          depends[i] = uint64_t (1) << node.slot;
+          break;
+        case AlgebraType::OPERATION:
+          depends[i] = depends[node.right];
+          if (node.val.operation != OperationType::NOT)
+            depends[i] |= depends[node.left];
+          break;
+        default: return nullptr;
+        }
+    }
+
+  Cones *result = new Cones;
+  result->inputs = inputs;
+  for (uint32_t input = 0; input < inputs; ++input)
+    {
+      result->starts.push_back (result->nodes.size ());
+      for (size_t i = 0; i < nodes.size (); ++i)
+        if ((depends[i] >> input) & 1) result->nodes.push_back (i);
+    }
+  result->starts.push_back (result->nodes.size ());
+  return result;
+}
+
+//! \brief Evaluate every node for 64 assignments, one word per node
+extern uint64_t
+evaluateNodes (Parser::NodeSpan nodes, const uint64_t *inputs,
+               uint64_t *values)
+{
+  if (nodes.empty ()) return 0;
+  for (size_t i = 0; i < nodes.size (); ++i)
+    values[i] = nodeWord (nodes[i], inputs, values);
+  return values[nodes.size () - 1];
+}
+
+//! \brief Evaluate again only the nodes an input changed
+extern uint64_t
+evaluateCone (Parser::NodeSpan nodes, const Cones &cones, uint32_t input,
+              const uint64_t *inputs, uint64_t *values)
+{
+  if (nodes.empty ()) return 0;
+  for (uint32_t c = cones.starts[input]; c < cones.starts[input + 1]; ++c)
+    {
+      uint32_t i = cones.nodes[c];
+      values[i] = nodeWord (nodes[i], inputs, values);
+    }
+  return values[nodes.size () - 1];
+}
+
+//! \brief Check that code keeps its operands and stack in bounds
+extern bool
+isValid (const Program &program)
+{
+  uint32_t depth = 0;
+  for (Instruction instruction : program.code)
+    {
+      uint32_t operand = instruction >> opBits;
+      switch (instruction & opMask)
+        {
+        case CONST: ++depth; break;
+        case LOAD:
+          if (operand >= program.inputs) return false;
+          ++depth;
+          break;
+        case AND:
+        case OR:
+          if (depth < 2) return false;
+          --depth;
+          break;
+        case NOT:
+          if (depth < 1) return false;
+          break;
+        case STORE:
+          if (depth < 1 || operand >= program.temps) return false;
+          break;
+        case TEMP:
+          if (operand >= program.temps) return false;
+          ++depth;
+          break;
+        default: return false;
+        }
+      if (depth > program.maxStack) return false;
+    }
+  return depth == 1;
+}
+
+//! \brief Run a program for one assignment of its inputs
+extern unsigned char
+run (const Program &program, const std::vector<unsigned char> &values)
+{
+  static thread_local std::vector<unsigned char> stack;
+  static thread_local std::vector<unsigned char> temps;
+  stack.resize (program.maxStack);
+  temps.resize (program.temps);
+  return execute<unsigned char> (program, values.data (), 1, stack.data (),
+                                 temps.data ());
+}
+
+//! \brief Run a program for 64 assignments at once, one per bit
+extern uint64_t
+runSliced (const Program &program, const uint64_t *inputs)
+{
+  static thread_local std::vector<uint64_t> stack;
+  static thread_local std::vector<uint64_t> temps;
+  stack.resize (program.maxStack);
+  temps.resize (program.temps);
+  return execute<uint64_t> (program, inputs, ~0ull, stack.data (),
+                            temps.data ());
+}
+
+extern void runAvx2 (const Program &program, const uint64_t *inputs,
+                     uint64_t *results);
+extern void runAvx512 (const Program &program, const uint64_t *inputs,
+                       uint64_t *results);
+
+static bool
+always ()
+{
+  return true;
+}
+
+static bool
+hasAvx2 ()
+{
+  return __builtin_cpu_supports ("avx2");
+}
+
+static bool
+hasAvx512 ()
+{
+  return __builtin_cpu_supports ("avx512f");
+}
+
+static void
+runScalar (const Program &program, const uint64_t *inputs, uint64_t *results)
+{
+  results[0] = runSliced (program, inputs);
+}
+
+static const Kernel allKernels[] = {
+  { "scalar", 1, always, runScalar },
+  { "avx2", 4, hasAvx2, runAvx2 },
+  { "avx512", 8, hasAvx512, runAvx512 },
+};
+
+//! \brief Every kernel, narrowest first
+extern std::span<const Kernel>
+kernels ()
+{
+  return allKernels;
+}
+
+//! \brief Widest kernel the CPU supports, detected on first use
+extern const Kernel &
+widestKernel ()
+{
+  static const Kernel &widest = [] () -> const Kernel & {
+    const Kernel *best = &allKernels[0];
+    for (const Kernel &kernel : allKernels)
+      if (kernel.supported ()) best = &kernel;
+    return *best;
+  }();
+  return widest;
+}
+} // end namespace Vm
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
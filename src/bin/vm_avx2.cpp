@@ -0,0 +1,38 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file vm_avx2.cpp
+ * \author Delyan Kirov
+ * \brief AVX2 evaluation kernel, 256 assignments per run
+ * \details Compiled with -mavx2, only called once the CPU is known to
+ *          support it.
+ *---------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+
+#include "vm.hpp"
+
+namespace Vm
+{
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE TYPES-------------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief 256 lanes in one register
+typedef uint64_t Wide256 __attribute__ ((vector_size (32)));
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE EXPR-----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Run a program for 256 assignments at once
+extern void
+runAvx2 (const Program &program, const uint64_t *inputs, uint64_t *results)
+{
+  runWide<Wide256> (program, inputs, results);
+}
+} // end namespace Vm
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
@@ -0,0 +1,38 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file vm_avx512.cpp
+ * \author Delyan Kirov
+ * \brief AVX-512 evaluation kernel, 512 assignments per run
+ * \details Compiled with -mavx512f, only called once the CPU is known to
+ *          support it.
+ *---------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+
+#include "vm.hpp"
+
+namespace Vm
+{
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE TYPES-------------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief 512 lanes in one register
+typedef uint64_t Wide512 __attribute__ ((vector_size (64)));
+
+/*----------------------------------------------------------------------/
+ *------------------------------MODULE EXPR-----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Run a program for 512 assignments at once
+extern void
+runAvx512 (const Program &program, const uint64_t *inputs, uint64_t *results)
+{
+  runWide<Wide512> (program, inputs, results);
+}
+} // end namespace Vm
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
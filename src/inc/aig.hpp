@@ -0,0 +1,111 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file aig.hpp
+ * \author Delyan Kirov
+ * \brief Interface for the And-Inverter Graph representation
+ *---------------------------------------------------------------------*/
+
+#ifndef AIG_H
+#define AIG_H
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+#include "parser.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE TYPES-------------------------------/
+ *---------------------------------------------------------------------*/
+
+namespace Aig
+{
+//! \brief Edge of the graph, node index shifted left with a complement bit
+using Literal = uint32_t;
+
+constexpr Literal FALSE = 0;
+constexpr Literal TRUE = 1;
+
+inline Literal
+negate (Literal literal)
+{
+  return literal ^ 1;
+}
+
+inline uint32_t
+nodeOf (Literal literal)
+{
+  return literal >> 1;
+}
+
+inline bool
+isComplemented (Literal literal)
+{
+  return literal & 1;
+}
+
+//! \brief Two input AND node
+struct AndNode
+{
+  Literal left;
+  Literal right;
+};
+
+//! \brief And-Inverter Graph of one definition
+//! \details Node 0 is the constant false and nodes 1..inputs are the
+//!          definition arguments, in argument order. Every other node is
+//!          a structurally hashed AND, stored after its fanins. NOT is a
+//!          complemented edge, OR is lowered with De Morgan.
+struct Graph
+{
+  uint32_t inputs = 0;
+  std::vector<AndNode> nodes{};
+  Literal output = FALSE;
+  std::unordered_map<uint64_t, Literal> strash{};
+
+  explicit Graph (uint32_t inputCount);
+
+  Literal
+  input (uint32_t slot) const
+  {
+    return (slot + 1) << 1;
+  }
+
+  bool
+  isAnd (Literal literal) const
+  {
+    return nodeOf (literal) > inputs;
+  }
+
+  //! \brief Return the AND of two literals, reusing an identical node
+  Literal createAnd (Literal left, Literal right);
+
+  //! \brief Number of AND nodes
+  size_t
+  andCount () const
+  {
+    return nodes.size () - inputs - 1;
+  }
+};
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE FUNCTIONS----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Lower bound syntax tree nodes, nullptr if a variable is unbound
+extern Graph *lower (Parser::NodeSpan tree, uint32_t inputs);
+
+//! \brief Rebuild the cone of the output applying local rewriting rules
+extern Graph *rewrite (const Graph &graph);
+
+//! \brief Evaluate the graph for one assignment of its inputs
+extern unsigned char evaluate (const Graph &graph,
+                               const std::vector<unsigned char> &values);
+}
+
+#endif // AIG_H
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
@@ -0,0 +1,75 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file bdd.hpp
+ * \author Delyan Kirov
+ * \brief Interface for the reduced ordered Binary Decision Diagrams
+ *---------------------------------------------------------------------*/
+
+#ifndef BDD_H
+#define BDD_H
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+#include "parser.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE TYPES-------------------------------/
+ *---------------------------------------------------------------------*/
+
+namespace Bdd
+{
+//! \brief Edge to a node, node index shifted left with a complement bit
+//! \details All diagrams share one unique table and order their variables
+//!          by argument slot, so two definitions over the same arguments
+//!          compute the same function exactly when their edges are equal.
+using Edge = uint32_t;
+
+constexpr Edge ONE = 0;  // The terminal node
+constexpr Edge ZERO = 1; // The complemented terminal node
+constexpr Edge NONE = UINT32_MAX;
+
+//! \brief Counters of the shared manager
+struct Stats
+{
+  uint64_t cacheLookups = 0;
+  uint64_t cacheHits = 0;
+  size_t liveNodes = 0; // Allocated nodes, terminal included
+  size_t collections = 0;
+};
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE FUNCTIONS----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Build the diagram of bound syntax tree nodes
+//! \return a referenced root, NONE if a variable is unbound
+extern Edge build (Parser::NodeSpan nodes);
+
+//! \brief Drop the reference on a root returned by build
+extern void release (Edge root);
+
+//! \brief Follow one path from the root, at most one node per input
+extern unsigned char evaluate (Edge root,
+                               const std::vector<unsigned char> &values);
+
+//! \brief Number of nodes reachable from a root, the terminal included
+extern size_t nodeCount (Edge root);
+
+//! \brief Number of satisfying assignments of the inputs, linear in size
+extern double satCount (Edge root, uint32_t inputs);
+
+//! \brief Free every node no referenced root reaches
+extern void collect ();
+
+//! \brief Statistics of the shared manager
+extern const Stats &stats ();
+}
+
+#endif // BDD_H
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
@@ -0,0 +1,34 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file image.hpp
+ * \author Delyan Kirov
+ * \brief Interface for binary namespace images
+ *---------------------------------------------------------------------*/
+
+#ifndef IMAGE_H
+#define IMAGE_H
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+#include "interpreter.hpp"
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE FUNCTIONS----------------------------/
+ *---------------------------------------------------------------------*/
+
+namespace Image
+{
+//! \brief Write the definitions of the program namespace to an image
+extern bool save (const char *fileName);
+
+//! \brief Map an image and add its definitions to the program namespace
+//! \details The bound node pools and their bytecode are used in place
+//!          from the mapping, only the names are interned.
+extern bool load (const char *fileName);
+}
+
+#endif // IMAGE_H
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
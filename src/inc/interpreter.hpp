@@ -10,7 +10,12 @@
 /*----------------------------------------------------------------------/
  *--------------------------MODULE INCLUDES-----------------------------/
  *---------------------------------------------------------------------*/
+#include "aig.hpp"
+#include "bdd.hpp"
+#include "jit.hpp"
 #include "parser.hpp"
+#include "symbols.hpp"
+#include "vm.hpp"
 #include <cstddef>
 #include <cstdio>
 #include <iostream>
@@ -25,9 +30,30 @@ namespace Interpreter
 //! \brief Define the FunctionDefinition struct
 struct Func
 {
-  std::string name;
-  std::vector<std::string> argNames;
-  Parser::SynTree *definition;
+  Symbols::Symbol name;
+  std::vector<Symbols::Symbol> argNames;
+  Parser::SynTree *definition;     // nullptr when loaded from an image
+  Parser::NodeSpan nodes{};        // Bound nodes, in definition or an image
+  Aig::Graph *aig = nullptr;
+  Vm::Program *program = nullptr;  // Bytecode used by RUN and ALL
+  Jit::Function *jit = nullptr;    // Machine code of program, if enabled
+  Vm::TruthTable *table = nullptr; // Every result, if enabled and small
+  Bdd::Edge bdd = Bdd::NONE;       // Referenced diagram root, if enabled
+  Vm::Cones *cones = nullptr;      // Input cones of nodes, if incremental
+  Parser::SynTree *reference = nullptr; // Unsimplified tree, if verifying
+};
+
+//! \brief Options that change how definitions are compiled and evaluated
+struct Options
+{
+  bool aig = false;    // Lower definitions into an And-Inverter Graph
+  bool stats = false;  // Report compilation statistics on stderr
+  bool verify = false; // Check compiled results against the tree walker
+  bool jit = false;    // Compile programs into x86-64 machine code
+  bool table = false;  // Tabulate definitions of up to 20 arguments
+  bool bdd = false;    // Build a reduced ordered BDD of every definition
+  bool incremental = false; // Evaluate ALL in Gray code order, by cones
+  unsigned threads = 1; // Threads evaluating the rows of ALL
 };
 
 /*----------------------------------------------------------------------/
@@ -36,6 +62,14 @@ struct Func
 
 //! \brief Function that interprets parser commands
 extern void interpret (Parser::Command command);
+
+//! \brief Evaluate the RUN commands waiting in the batch
+//! \details Consecutive RUN commands of one function are batched, this
+//!          must be called before their output is expected.
+extern void flush ();
+
+//! \brief Add a function to the program namespace, compiled as configured
+extern void define (Func func);
 }
 
 /*----------------------------------------------------------------------/
@@ -45,6 +79,9 @@ extern void interpret (Parser::Command command);
 //! \brief Declare the global program namespace
 extern std::vector<Interpreter::Func> programNameSpace;
 
+//! \brief Declare the global interpreter options
+extern Interpreter::Options programOptions;
+
 #endif // INTERPRETER_H
 
 /*----------------------------------------------------------------------/
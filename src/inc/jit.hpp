@@ -0,0 +1,61 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file jit.hpp
+ * \author Delyan Kirov
+ * \brief Interface for the x86-64 compiler of bytecode programs
+ *---------------------------------------------------------------------*/
+
+#ifndef JIT_H
+#define JIT_H
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+#include "vm.hpp"
+#include <cstddef>
+#include <cstdint>
+
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE TYPES-------------------------------/
+ *---------------------------------------------------------------------*/
+
+namespace Jit
+{
+//! \brief Generated code, 64 bit-sliced assignments per call
+//! \param inputs one word per input slot
+//! \param scratch temporaries and spilled stack entries
+using Entry = uint64_t (*) (const uint64_t *inputs, uint64_t *scratch);
+
+//! \brief Straight-line machine code of a program in executable memory
+struct Function
+{
+  Entry entry = nullptr;
+  void *memory = nullptr;
+  size_t size = 0;      // Bytes mapped
+  size_t length = 0;    // Bytes of code
+  uint32_t scratch = 0; // Words of scratch space the code uses
+
+  Function () = default;
+  Function (const Function &) = delete;
+  Function &operator= (const Function &) = delete;
+  ~Function ();
+};
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE FUNCTIONS----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Check if machine code can be generated on this platform
+extern bool supported ();
+
+//! \brief Compile a program into machine code, nullptr if unsupported
+extern Function *compile (const Vm::Program &program);
+
+//! \brief Call the code for 64 assignments, one per bit of the inputs
+extern uint64_t run (const Function &function, const uint64_t *inputs);
+}
+
+#endif // JIT_H
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
@@ -0,0 +1,68 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file minimize.hpp
+ * \author Delyan Kirov
+ * \brief Interface for the two-level minimization of sums of products
+ *---------------------------------------------------------------------*/
+
+#ifndef MINIMIZE_H
+#define MINIMIZE_H
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE TYPES-------------------------------/
+ *---------------------------------------------------------------------*/
+
+namespace Minimize
+{
+//! \brief Product of literals, input i is in it when bit i of care is set
+//!        and negated when bit i of value is clear
+//! \details value has no bit outside of care, a cube with every bit of
+//!          care set is a single row, a minterm.
+struct Cube
+{
+  uint64_t care;
+  uint64_t value;
+};
+
+//! \brief Size of a sum of products
+struct Cost
+{
+  size_t terms;
+  size_t literals;
+};
+
+//! \brief Inputs up to which the cover is searched exactly
+constexpr uint32_t exactInputs = 8;
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE FUNCTIONS----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Terms and literals of a sum of products
+extern Cost cost (const std::vector<Cube> &cubes);
+
+//! \brief Sum of products of the same function as the minterms of onSet,
+//!        every row outside of onSet is 0
+//! \details Up to exactInputs inputs the primes are generated as by
+//!          Quine-McCluskey and a fewest terms, then fewest literals, cover
+//!          is searched by branch and bound, which keeps the best cover
+//!          found so far if it runs out of nodes. Above that the cover is
+//!          improved with the expand, irredundant and reduce steps of
+//!          Espresso until it stops shrinking.
+//! \param minimal if given, set to whether the cover is known minimal
+extern std::vector<Cube> minimize (const std::vector<Cube> &onSet,
+                                   uint32_t inputs,
+                                   bool *minimal = nullptr);
+}
+
+#endif // MINIMIZE_H
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
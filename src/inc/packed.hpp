@@ -0,0 +1,71 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file packed.hpp
+ * \author Delyan Kirov
+ * \brief Interface for bit-packed truth table files
+ *---------------------------------------------------------------------*/
+
+#ifndef PACKED_H
+#define PACKED_H
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+#include "symbols.hpp"
+#include "vm.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE TYPES-------------------------------/
+ *---------------------------------------------------------------------*/
+
+namespace Packed
+{
+constexpr char packedMagic[8] = { 'D', 'I', 'S', 'T', 'A', 'B', 'L', 'E' };
+constexpr uint32_t packedVersion = 1;
+
+//! \brief File layout: Header, the argument names each ended by a newline,
+//!        zero padding up to bitsOffset and the result of every row, row r
+//!        in bit r % 64 of the little endian word r / 64. Rows are
+//!        numbered as in ALL, the first argument the highest bit.
+struct Header
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t inputs;     // The file holds 2^inputs rows
+  uint64_t namesSize;  // Bytes of argument names after the header
+  uint64_t bitsOffset; // A multiple of 64
+};
+
+//! \brief Fills the words of the rows [first, first + count)
+using Fill = std::function<void (uint64_t first, uint64_t count,
+                                 uint64_t *bits)>;
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE FUNCTIONS----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Rows fill is asked for at once, 1 MiB of bits
+constexpr uint64_t chunkRows = uint64_t (1) << 23;
+
+//! \brief Write a truth table file chunk by chunk
+//! \details Only one chunk of bits is held in memory, whatever the number
+//!          of arguments. Chunks start at a multiple of chunkRows. The
+//!          file is written aside and renamed over fileName, so tables
+//!          loaded from the old file stay mapped.
+extern bool save (const char *fileName,
+                  const std::vector<Symbols::Symbol> &arguments,
+                  const Fill &fill);
+
+//! \brief Map a truth table file, its bits are used in place
+//! \return nullptr if the file can not be mapped or is corrupt
+extern Vm::TruthTable *load (const char *fileName,
+                             std::vector<Symbols::Symbol> &arguments);
+}
+
+#endif // PACKED_H
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
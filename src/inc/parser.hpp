@@ -10,7 +10,11 @@
 /*----------------------------------------------------------------------/
  *--------------------------MODULE INCLUDES-----------------------------/
  *---------------------------------------------------------------------*/
+#include "symbols.hpp"
 #include "tokenizer.hpp"
+#include <cstdint>
+#include <span>
+#include <string>
 
 /*----------------------------------------------------------------------/
  *---------------------------MODULE TYPES-------------------------------/
@@ -22,7 +26,7 @@ using Tokenizer::Token;
 using Tokenizer::TokenType;
 
 //! \brief Enum for operation types
-enum class OperationType
+enum class OperationType : unsigned char
 {
   AND,
   OR,
@@ -30,21 +34,23 @@ enum class OperationType
 };
 
 //! \brief Enum for algebraic types
-enum class AlgebraType
+enum class AlgebraType : unsigned char
 {
   VALUE,
   OPERATION,
   VARIABLE,
-  NONE // Default state
+  CALL,     // Call of a definition, resolved when DEFINE is interpreted
+  ARGUMENT, // One argument of a call
+  NONE      // Default state
 };
 
 //! \brief for algebraic expressions
 struct Algebra
 {
-  AlgebraType type;
-  unsigned char value;
-  OperationType operation;
-  std::string variable;
+  AlgebraType type = AlgebraType::NONE;
+  unsigned char value = 0;
+  OperationType operation = OperationType::AND;
+  Symbols::Symbol variable = Symbols::NONE;
 };
 
 //! \brief Enum for the types of commands
@@ -55,10 +61,19 @@ enum class CommandType
   ALL,
   FIND,
   CLEAR,
+  LOAD,
   TRIVIAL,
   EXIT,
 };
 
+//! \brief What ALL reports about the rows of a definition
+enum class AllMode : unsigned char
+{
+  ROWS,  // Print every row
+  COUNT, // Count the rows that output 1
+  FIRST, // Print the first rows that output 1
+};
+
 //! \brief Structure for table representation
 struct Table
 {
@@ -68,32 +83,64 @@ struct Table
   std::vector<unsigned char> output{};
 };
 
-//! \brief Structure for syntax tree nodes
-struct SynTree
+//! \brief Index of a node inside a SynTree node pool
+using NodeIndex = uint32_t;
+
+//! \brief Index used for a missing child
+constexpr NodeIndex NO_NODE = UINT32_MAX;
+
+//! \brief Slot of a variable that is not an argument of its definition
+constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+//! \brief Fixed size syntax tree node, children are pool indices
+//! \details Variable leaves have no children, once bound to their
+//!          definition they keep the index of their argument in slot.
+//!          A call names its definition in val.variable and links its
+//!          arguments through right, each argument holds its expression in
+//!          left and the next argument in right.
+struct SynNode
 {
   Algebra val;
-  SynTree *left;
-  SynTree *right;
+  union
+  {
+    NodeIndex left;
+    uint32_t slot;
+  };
+  NodeIndex right;
+};
+static_assert (sizeof (SynNode) == 16, "SynNode must stay compact");
+
+//! \brief Read-only view of a node pool, owned by a SynTree or an image
+using NodeSpan = std::span<const SynNode>;
 
-  SynTree (const Algebra &value, SynTree *leftNode = nullptr,
-           SynTree *rightNode = nullptr)
-      : val (value), left (leftNode), right (rightNode)
+//! \brief Node pool holding the syntax tree of one definition
+//! \details Nodes are stored contiguously in evaluation (post) order:
+//!          children always come before their parent and the root is the
+//!          last node. Once simplified, equal subtrees are shared.
+//!          Deleting the tree releases the whole pool at once.
+struct SynTree
+{
+  std::vector<SynNode> nodes{};
+
+  NodeIndex
+  push (const Algebra &value, NodeIndex leftNode = NO_NODE,
+        NodeIndex rightNode = NO_NODE)
   {
+    nodes.push_back ({ value, leftNode, rightNode });
+    return nodes.size () - 1;
   }
-  void
-  destroy ()
+
+  NodeIndex
+  root () const
   {
-    // Recursively delete left and right subtrees
-    if (this->left != nullptr)
-      {
-        delete this->left;
-        left = nullptr;
-      }
-    if (this->right != nullptr)
-      {
-        delete this->right;
-        right = nullptr;
-      }
+    return nodes.empty () ? NO_NODE : nodes.size () - 1;
+  }
+
+  //! \brief Heap and header memory held by the tree
+  size_t
+  bytes () const
+  {
+    return sizeof (SynTree) + nodes.capacity () * sizeof (SynNode);
   }
 };
 
@@ -102,10 +149,13 @@ struct Command
 {
   SynTree *definition = nullptr;
   CommandType type = CommandType::TRIVIAL;
-  std::vector<std::string> arguments{};
+  std::vector<Symbols::Symbol> arguments{};
   std::vector<unsigned char> values{};
   Table table{};
-  std::string name = "";
+  Symbols::Symbol name = Symbols::NONE;
+  std::string fileName{}; // Batch RUN input, ALL output or LOAD table
+  AllMode mode = AllMode::ROWS;
+  uint64_t limit = 0; // Rows printed by ALL FIRST
 };
 
 /*----------------------------------------------------------------------/
@@ -115,6 +165,15 @@ struct Command
 //! \brief Parse tokens
 extern std::pair<size_t, Command> parse (size_t idx,
                                           std::vector<Token> *tokens);
+
+//! \brief Parse a compact token stream
+extern std::pair<size_t, Command>
+parse (size_t idx, const Tokenizer::TokenStream *tokens);
+
+//! \brief Bind variable leaves to their argument slot
+//! \return Number of leaves that name no argument
+extern size_t bindArguments (SynTree &tree,
+                             const std::vector<Symbols::Symbol> &arguments);
 }
 
 /*----------------------------------------------------------------------/
@@ -139,7 +198,8 @@ to_string (const Parser::Algebra &val)
         case OperationType::NOT: return "!";
         default                : return "UNKNOWN ALGEBRA OPERATION TYPE";
         }
-    case AlgebraType::VARIABLE: return val.variable;
+    case AlgebraType::VARIABLE:
+    case AlgebraType::CALL    : return Symbols::name (val.variable);
     default                   : return "UNKNOWN ALGEBRATYPE";
     }
 }
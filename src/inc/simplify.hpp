@@ -0,0 +1,32 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file simplify.hpp
+ * \author Delyan Kirov
+ * \brief Interface for the Boolean simplification of syntax trees
+ *---------------------------------------------------------------------*/
+
+#ifndef SIMPLIFY_H
+#define SIMPLIFY_H
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+#include "parser.hpp"
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE FUNCTIONS----------------------------/
+ *---------------------------------------------------------------------*/
+
+namespace Simplify
+{
+//! \brief Simplify a bound syntax tree in place
+//! \details Folds constants, cancels double negations and applies the
+//!          idempotence, complement and absorption laws one level deep.
+//!          Equal subtrees are shared, so the pool may become a DAG.
+extern void simplify (Parser::SynTree &tree);
+}
+
+#endif // SIMPLIFY_H
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
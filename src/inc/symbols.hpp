@@ -0,0 +1,48 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file symbols.hpp
+ * \author Delyan Kirov
+ * \brief Interface for the interned symbol table
+ *---------------------------------------------------------------------*/
+
+#ifndef SYMBOLS_H
+#define SYMBOLS_H
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE TYPES-------------------------------/
+ *---------------------------------------------------------------------*/
+
+namespace Symbols
+{
+//! \brief Dense id of an interned identifier
+using Symbol = uint32_t;
+
+//! \brief Id carried by tokens and commands that have no name
+constexpr Symbol NONE = UINT32_MAX;
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE FUNCTIONS----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Return the id of name, adding it to the table if needed
+extern Symbol intern (std::string_view name);
+
+//! \brief Return the identifier of an interned id
+extern const std::string &name (Symbol symbol);
+
+//! \brief Return the number of interned identifiers
+extern size_t count ();
+}
+
+#endif // SYMBOLS_H
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/
@@ -10,7 +10,11 @@
 /*----------------------------------------------------------------------/
  *--------------------------MODULE INCLUDES-----------------------------/
  *---------------------------------------------------------------------*/
+#include "symbols.hpp"
+#include <cstdint>
 #include <iostream>
+#include <stdexcept>
+#include <string_view>
 #include <vector>
 
 /*----------------------------------------------------------------------/
@@ -20,7 +24,7 @@
 namespace Tokenizer
 {
 //! \brief Enum for token types
-enum class TokenType
+enum class TokenType : unsigned char
 {
   PAREN_L,
   PAREN_R,
@@ -29,6 +33,7 @@ enum class TokenType
   ALL,
   FIND,
   CLEAR,
+  LOAD,
   VAR_NAME,
   VAL,
   NEWLINE,
@@ -47,6 +52,67 @@ struct Token
   TokenType type;
   unsigned char val;
   std::string name;
+  Symbols::Symbol symbol = Symbols::NONE;
+};
+
+//! \brief Value view of a single token inside a TokenStream
+struct TokenView
+{
+  TokenType type;
+  unsigned char val;
+  std::string_view name;
+  Symbols::Symbol symbol;
+};
+
+//! \brief Compact token stream in struct-of-arrays layout
+//! \details Tokens only carry their type and an offset/length pair into
+//!          the input buffer, so the buffer must outlive the stream.
+//!          Names are interned, their ids are kept in symbols.
+struct TokenStream
+{
+  const char *buffer = nullptr;
+  std::vector<TokenType> types{};
+  std::vector<uint32_t> offsets{};
+  std::vector<uint32_t> lengths{};
+  std::vector<Symbols::Symbol> symbols{};
+
+  size_t
+  size () const
+  {
+    return types.size ();
+  }
+
+  TokenView
+  operator[] (size_t idx) const
+  {
+    TokenType type = types[idx];
+    if (type == TokenType::VAL)
+      return { type, (unsigned char)(buffer[offsets[idx]] == '1'), {},
+               Symbols::NONE };
+    if (type == TokenType::VAR_NAME)
+      return { type, 2, { buffer + offsets[idx], lengths[idx] },
+               symbols[idx] };
+    return { type, 2, {}, Symbols::NONE };
+  }
+
+  TokenView
+  at (size_t idx) const
+  {
+    if (idx >= size ()) throw std::out_of_range ("TokenStream::at");
+    return (*this)[idx];
+  }
+};
+
+//! \brief Read-only memory mapping of an input file
+struct MappedFile
+{
+  const char *data = nullptr;
+  size_t size = 0;
+
+  MappedFile () = default;
+  MappedFile (const MappedFile &) = delete;
+  MappedFile &operator= (const MappedFile &) = delete;
+  ~MappedFile ();
 };
 
 /*----------------------------------------------------------------------/
@@ -58,6 +124,16 @@ extern void printTokens (const std::vector<Token> &tokens);
 
 //! \brief Function to tokenize the input file
 extern std::vector<Token> *tokenize (FILE *file);
+
+//! \brief Function to tokenize an in-memory buffer into a compact stream
+extern TokenStream tokenize (const char *buffer, size_t size);
+
+//! \brief Function to tokenize an in-memory buffer on several threads
+extern TokenStream tokenizeParallel (const char *buffer, size_t size,
+                                     unsigned threads);
+
+//! \brief Map a regular file into memory, nullptr if it can not be mapped
+extern MappedFile *mapFile (const char *fileName);
 }
 
 /*----------------------------------------------------------------------/
@@ -79,6 +155,7 @@ to_string (const Tokenizer::TokenType &type)
     case TokenType::RUN     : return "RUN";
     case TokenType::FIND    : return "FIND";
     case TokenType::CLEAR   : return "CLEAR";
+    case TokenType::LOAD    : return "LOAD";
     case TokenType::ALL     : return "ALL";
     case TokenType::VAR_NAME: return "VAR_NAME";
     case TokenType::VAL     : return "VAL";
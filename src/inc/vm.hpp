@@ -0,0 +1,261 @@
+/*-----------------------------MODULE INFO-----------------------------/
+ * \file vm.hpp
+ * \author Delyan Kirov
+ * \brief Interface for the postfix bytecode evaluator
+ *---------------------------------------------------------------------*/
+
+#ifndef VM_H
+#define VM_H
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE INCLUDES-----------------------------/
+ *---------------------------------------------------------------------*/
+#include "aig.hpp"
+#include "parser.hpp"
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+/*----------------------------------------------------------------------/
+ *---------------------------MODULE TYPES-------------------------------/
+ *---------------------------------------------------------------------*/
+
+namespace Vm
+{
+//! \brief Opcodes, stored in the low bits of an instruction
+enum Op : uint32_t
+{
+  CONST, // Push operand as a constant 0 or 1
+  LOAD,  // Push input slot operand
+  AND,   // Pop two, push their AND
+  OR,    // Pop two, push their OR
+  NOT,   // Complement the top of the stack
+  STORE, // Copy the top of the stack into temporary operand
+  TEMP,  // Push temporary operand
+};
+
+//! \brief Instruction, the opcode in the low opBits and the operand above
+using Instruction = uint32_t;
+
+constexpr uint32_t opBits = 3;
+constexpr uint32_t opMask = (1 << opBits) - 1;
+
+inline Instruction
+encode (Op op, uint32_t operand = 0)
+{
+  return operand << opBits | op;
+}
+
+//! \brief Compiled definition, a flat postfix program
+//! \details Subexpressions shared in a DAG are computed once, kept in a
+//!          temporary with STORE and reused with TEMP. The code is either
+//!          owned in storage or lives in a mapped namespace image.
+struct Program
+{
+  uint32_t inputs = 0;
+  uint32_t maxStack = 0;
+  uint32_t temps = 0;
+  std::span<const Instruction> code{};
+  std::vector<Instruction> storage{};
+};
+
+//! \brief Result of every row of a program, row r in bit r % 64 of word
+//!        r / 64
+//! \details Rows are numbered as in ALL, the first input the highest bit.
+//!          The bits are either owned in storage or live in a mapped
+//!          truth table file.
+struct TruthTable
+{
+  uint32_t inputs = 0;
+  std::span<const uint64_t> bits{};
+  std::vector<uint64_t> storage{};
+
+  //! \brief Result of one assignment of the inputs
+  unsigned char
+  lookup (const unsigned char *values) const
+  {
+    uint64_t row = 0;
+    for (uint32_t i = 0; i < inputs; ++i)
+      row = row << 1 | (values[i] & 1);
+    return (bits[row / 64] >> (row % 64)) & 1;
+  }
+};
+
+//! \brief Largest number of inputs tabulate accepts, 2^20 bits = 128 KiB
+constexpr uint32_t maxTableInputs = 20;
+
+//! \brief Nodes of a pool to evaluate again when one of its inputs changes
+//! \details The cone of input i is nodes[starts[i]] to
+//!          nodes[starts[i + 1] - 1], every node depending on it in post
+//!          order. A node shared in a DAG appears once per cone.
+struct Cones
+{
+  uint32_t inputs = 0;
+  std::vector<uint32_t> starts{};
+  std::vector<uint32_t> nodes{};
+};
+
+/*----------------------------------------------------------------------/
+ *--------------------------MODULE FUNCTIONS----------------------------/
+ *---------------------------------------------------------------------*/
+
+//! \brief Compile bound syntax tree nodes, nullptr if a variable is unbound
+extern Program *compile (Parser::NodeSpan nodes, uint32_t inputs);
+
+//! \brief Compile an And-Inverter Graph
+extern Program *compile (const Aig::Graph &graph);
+
+//! \brief Evaluate every row of a program into a truth table
+//! \return nullptr if the program has more than maxTableInputs inputs
+extern TruthTable *tabulate (const Program &program);
+
+//! \brief Find the cone of every input of bound syntax tree nodes
+//! \return nullptr if a variable is unbound or there are over 64 inputs
+extern Cones *cones (Parser::NodeSpan nodes, uint32_t inputs);
+
+//! \brief Evaluate every node for 64 assignments, one word per node
+//! \param inputs one word per input slot
+//! \param values one word per node, the cache evaluateCone updates
+//! \return the word of the root
+extern uint64_t evaluateNodes (Parser::NodeSpan nodes, const uint64_t *inputs,
+                               uint64_t *values);
+
+//! \brief Evaluate again only the nodes an input changed
+//! \details values must hold the nodes evaluated for the same inputs
+//!          except the word of input, which costs the size of its cone
+//!          instead of the whole pool.
+//! \return the word of the root
+extern uint64_t evaluateCone (Parser::NodeSpan nodes, const Cones &cones,
+                              uint32_t input, const uint64_t *inputs,
+                              uint64_t *values);
+
+//! \brief Check that code keeps its operands and stack in bounds
+extern bool isValid (const Program &program);
+
+//! \brief Run a program for one assignment of its inputs
+extern unsigned char run (const Program &program,
+                          const std::vector<unsigned char> &values);
+
+//! \brief Lanes of a bit-sliced word, one assignment per bit
+constexpr uint32_t sliceLanes = 64;
+
+//! \brief Input word of a slot for 64 consecutive rows of the ALL order
+//! \details Rows count up with the last input as the lowest bit, lane j of
+//!          the word holds row firstRow + j, firstRow being a multiple of 64.
+inline uint64_t
+sliceInput (uint32_t slot, uint32_t inputs, uint64_t firstRow)
+{
+  // Lane patterns of the six lowest row bits
+  constexpr uint64_t patterns[6]
+      = { 0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull,
+          0xF0F0F0F0F0F0F0F0ull, 0xFF00FF00FF00FF00ull,
+          0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull };
+  uint32_t bit = inputs - 1 - slot;
+  if (bit < 6) return patterns[bit];
+  return bit < 64 && (firstRow >> bit) & 1 ? ~0ull : 0;
+}
+
+//! \brief Input words of every slot for words * 64 rows from firstRow
+//! \details Only the slots whose row bits differ from the block starting at
+//!          previousRow are written, so stepping through the rows in order
+//!          touches about two slots per block. Pass ~firstRow to write all.
+//! \param block inputs * words words in the layout of Kernel::run
+inline void
+sliceBlock (uint32_t inputs, uint32_t words, uint64_t firstRow,
+            uint64_t previousRow, uint64_t *block)
+{
+  uint64_t changed = (firstRow ^ previousRow) & ((uint64_t (1) << inputs) - 1);
+  for (; changed != 0; changed &= changed - 1)
+    {
+      uint32_t slot = inputs - 1 - std::countr_zero (changed);
+      for (uint32_t word = 0; word < words; ++word)
+        block[slot * words + word]
+            = sliceInput (slot, inputs, firstRow + word * sliceLanes);
+    }
+}
+
+//! \brief Run a program for 64 assignments at once, one per bit
+//! \param inputs one word per input slot
+extern uint64_t runSliced (const Program &program, const uint64_t *inputs);
+
+//! \brief Bit-sliced evaluation kernel of one vector width
+//! \details A run evaluates words * 64 assignments. Input slot i is given
+//!          as the words inputs[i * words] to inputs[i * words + words - 1]
+//!          and lane j of the result is bit j % 64 of results[j / 64].
+struct Kernel
+{
+  const char *name;
+  uint32_t words;
+  bool (*supported) ();
+  void (*run) (const Program &program, const uint64_t *inputs,
+               uint64_t *results);
+};
+
+//! \brief Every kernel, narrowest first
+extern std::span<const Kernel> kernels ();
+
+//! \brief Widest kernel the CPU supports, detected on first use
+extern const Kernel &widestKernel ();
+
+//! \brief Stack machine shared by every word width
+//! \param inputs one word per input slot
+//! \param ones the word with every lane set, the value of constant 1
+//! \param stack scratch space of program.maxStack words
+//! \param temps scratch space of program.temps words
+template <typename Word>
+inline Word
+execute (const Program &program, const Word *inputs, Word ones, Word *stack,
+         Word *temps)
+{
+  size_t top = 0; // Number of words on the stack
+  for (Instruction instruction : program.code)
+    {
+      uint32_t operand = instruction >> opBits;
+      switch (instruction & opMask)
+        {
+        case CONST: stack[top++] = operand ? ones : Word (); break;
+        case LOAD : stack[top++] = inputs[operand]; break;
+        case AND  :
+          --top;
+          stack[top - 1] &= stack[top];
+          break;
+        case OR:
+          --top;
+          stack[top - 1] |= stack[top];
+          break;
+        case NOT  : stack[top - 1] ^= ones; break;
+        case STORE: temps[operand] = stack[top - 1]; break;
+        case TEMP : stack[top++] = temps[operand]; break;
+        }
+    }
+  return stack[0];
+}
+
+//! \brief Run a program over Wide vectors of 64-bit words
+//! \details Instantiated only in the translation units compiled for the
+//!          instruction set of Wide.
+template <typename Wide>
+inline void
+runWide (const Program &program, const uint64_t *inputs, uint64_t *results)
+{
+  static thread_local std::vector<Wide> words;
+  static thread_local std::vector<Wide> stack;
+  static thread_local std::vector<Wide> temps;
+  words.resize (program.inputs);
+  stack.resize (program.maxStack);
+  temps.resize (program.temps);
+  std::memcpy (static_cast<void *> (words.data ()), inputs,
+               program.inputs * sizeof (Wide));
+  Wide result = execute<Wide> (program, words.data (), ~Wide (),
+                               stack.data (), temps.data ());
+  std::memcpy (results, &result, sizeof (Wide));
+}
+}
+
+#endif // VM_H
+
+/*----------------------------------------------------------------------/
+ *-----------------------------------EOF--------------------------------/
+ *---------------------------------------------------------------------*/